@@ -0,0 +1,21 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace bench {
+
+    // runs f once and returns the elapsed time in milliseconds
+    template<typename F>
+    double measure(F&& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(stop - start).count();
+    }
+
+    inline void report(const char* name, double ms, std::size_t ops) {
+        std::printf("%-40s %10.3f ms %10.2f ns/op\n", name, ms, ms * 1e6 / static_cast<double>(ops));
+    }
+
+}
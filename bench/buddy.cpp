@@ -0,0 +1,70 @@
+#include "bench.hpp"
+#include "ulink_buddy.hpp"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main() {
+
+    constexpr int kSteps = 2000000;
+    constexpr std::size_t kLive = 2048;
+
+    alignas(4096) static unsigned char region[32 * 1024 * 1024];
+    ulink::BuddyAllocator<12, 20> buddy(region, sizeof(region));
+
+    // page-granular requests, 1 to 16 pages
+    std::mt19937 rng(42);
+    std::vector<std::size_t> sizes(kSteps);
+    std::vector<std::size_t> slots(kSteps);
+    for (int i = 0; i < kSteps; i++) {
+        sizes[i] = 4096 * (1 + rng() % 16);
+        slots[i] = rng() % kLive;
+    }
+
+    auto run = [&] (auto alloc, auto release) {
+        std::vector<void*> live(kLive, nullptr);
+        for (int i = 0; i < kSteps; i++) {
+            auto& slot = live[slots[i]];
+            if (slot) {
+                release(slot);
+                slot = nullptr;
+            }
+            else {
+                slot = alloc(sizes[i]);
+            }
+        }
+        for (void* p : live) {
+            if (p) release(p);
+        }
+    };
+
+    double ms = bench::measure([&] {
+        run([&] (std::size_t s) { return buddy.allocate(s); }, [&] (void* p) { buddy.deallocate(p); });
+    });
+    bench::report("BuddyAllocator<12, 20>", ms, kSteps);
+
+    ms = bench::measure([&] {
+        run([] (std::size_t s) { return std::malloc(s); }, [] (void* p) { std::free(p); });
+    });
+    bench::report("malloc", ms, kSteps);
+
+    // fragmentation after a random workload keeping about a third of the region busy
+    std::vector<void*> held;
+    for (int i = 0; i < kSteps / 100; i++) {
+        if (void* p = buddy.allocate(sizes[i])) held.push_back(p);
+        if (held.size() > kLive / 8) {
+            buddy.deallocate(held[slots[i] % held.size()]);
+            held[slots[i] % held.size()] = held.back();
+            held.pop_back();
+        }
+    }
+
+    const auto s = buddy.stats();
+    std::printf("free %zu / %zu bytes in %zu blocks, largest %zu, fragmentation %.3f\n",
+        s.free, s.total, s.free_blocks, s.largest_free, s.fragmentation());
+
+    for (void* p : held) buddy.deallocate(p);
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "bench.hpp"
+#include "ulink.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+struct Event : ulink::Node<Event> {
+    long timestamp;
+};
+
+int main() {
+
+    constexpr std::size_t kCount = 200000;
+    const long disorders[] = { 0, 1, 8, 64, 512, 4096 };
+
+    auto less = [] (const Event& a, const Event& b) { return a.timestamp < b.timestamp; };
+
+    std::vector<Event> events(kCount);
+    std::mt19937 rng(42);
+
+    for (long disorder : disorders) {
+
+        // timestamps increase by one on average, shifted by up to "disorder"
+        std::uniform_int_distribution<long> jitter(0, disorder);
+        for (std::size_t i = 0; i < kCount; i++) {
+            events[i].timestamp = static_cast<long>(i) + jitter(rng);
+        }
+
+        std::printf("disorder %ld\n", disorder);
+
+        {
+            ulink::List<Event> list;
+            const double ms = bench::measure([&] {
+                for (auto& e : events) {
+                    list.insert_sorted(e, less);
+                }
+            });
+            bench::report("  insert_sorted", ms, kCount);
+        }
+
+        {
+            ulink::List<Event> list;
+            const double ms = bench::measure([&] {
+                auto hint = list.end();
+                for (auto& e : events) {
+                    hint = list.insert_sorted_hint(hint, e, less);
+                }
+            });
+            bench::report("  insert_sorted_hint (last inserted)", ms, kCount);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include "bench.hpp"
+#include "ulink_parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+struct Job : ulink::Node<Job> {
+    double input;
+    double output;
+};
+
+int main() {
+
+    constexpr std::size_t kCount = 4000000;
+
+    std::vector<Job> jobs(kCount);
+    ulink::List<Job> list;
+
+    for (std::size_t i = 0; i < kCount; i++) {
+        jobs[i].input = static_cast<double>(i);
+        list.push_back(jobs[i]);
+    }
+
+    const std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (std::size_t threads = 1; threads <= maxThreads; threads++) {
+
+        const double ms = bench::measure([&] {
+            ulink::parallel_for_each(list, [] (Job& j) {
+                j.output = std::sqrt(j.input) * std::log1p(j.input);
+            }, threads);
+        });
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "parallel_for_each %zu thread(s)", threads);
+        bench::report(name, ms, kCount);
+    }
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "bench.hpp"
+#include "ulink_parallel.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct Record : ulink::Node<Record> {
+    unsigned key;
+};
+
+int main() {
+
+    constexpr std::size_t kCount = 2000000;
+
+    std::vector<Record> records(kCount);
+    std::vector<unsigned> keys(kCount);
+    std::mt19937 rng(42);
+
+    for (auto& k : keys) {
+        k = static_cast<unsigned>(rng());
+    }
+
+    auto less = [] (const Record& a, const Record& b) { return a.key < b.key; };
+
+    const std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (std::size_t threads = 1; threads <= maxThreads; threads++) {
+
+        ulink::List<Record> list;
+        for (std::size_t i = 0; i < kCount; i++) {
+            records[i].key = keys[i];
+            list.push_back(records[i]);
+        }
+
+        const double ms = bench::measure([&] {
+            ulink::parallel_sort(list, less, threads);
+        });
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "parallel_sort %zu thread(s)", threads);
+        bench::report(name, ms, kCount);
+    }
+
+    return 0;
+}
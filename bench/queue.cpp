@@ -0,0 +1,101 @@
+#include "bench.hpp"
+
+#include "ulink.hpp"
+#include "ulink_queue.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    constexpr std::size_t kItems = 200000;
+
+    struct Item : ulink::QueueNode<Item>, ulink::Node<Item> {};
+
+    // mutex + List with the same interface as the ulink queues
+    struct LockedList {
+        void push(Item& item) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mList.push_back(item);
+        }
+        Item* pop() {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mList.empty()) {
+                return nullptr;
+            }
+            Item& item = mList.front();
+            mList.pop_front();
+            return &item;
+        }
+        std::mutex mMutex;
+        ulink::List<Item> mList;
+    };
+
+    // "producers" threads push kItems nodes between them, "consumers"
+    // threads pop them all
+    template<typename queue_t>
+    double run(std::size_t producers, std::size_t consumers) {
+
+        queue_t queue;
+        std::vector<Item> items(kItems);
+        std::atomic<std::size_t> popped { 0 };
+
+        return bench::measure([&] {
+
+            std::vector<std::thread> threads;
+
+            for (std::size_t p = 0; p < producers; p++) {
+                threads.emplace_back([&, p] {
+                    for (std::size_t i = p; i < kItems; i += producers) {
+                        queue.push(items[i]);
+                    }
+                });
+            }
+
+            for (std::size_t c = 0; c < consumers; c++) {
+                threads.emplace_back([&] {
+                    while (popped.load(std::memory_order_relaxed) < kItems) {
+                        if (queue.pop()) {
+                            popped.fetch_add(1, std::memory_order_relaxed);
+                        }
+                        else {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+
+            for (auto& t : threads) {
+                t.join();
+            }
+        });
+    }
+
+}
+
+int main() {
+
+    char label[64];
+
+    for (std::size_t threads : { 2, 4, 8, 16, 32, 64 }) {
+
+        const std::size_t half = threads / 2;
+
+        std::snprintf(label, sizeof(label), "mutex + List %zuP/%zuC", half, half);
+        bench::report(label, run<LockedList>(half, half), kItems);
+
+        // one hazard slot per thread at the largest run, none waits for a slot
+        std::snprintf(label, sizeof(label), "MpmcQueue %zuP/%zuC", half, half);
+        bench::report(label, run<ulink::MpmcQueue<Item, 64>>(half, half), kItems);
+
+        std::snprintf(label, sizeof(label), "mutex + List %zuP/1C", threads - 1);
+        bench::report(label, run<LockedList>(threads - 1, 1), kItems);
+
+        std::snprintf(label, sizeof(label), "MpscQueue %zuP/1C", threads - 1);
+        bench::report(label, run<ulink::MpscQueue<Item>>(threads - 1, 1), kItems);
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "bench.hpp"
+#include "ulink_scheduler.hpp"
+
+#include <chrono>
+#include <vector>
+
+namespace {
+
+    using Sched = ulink::Scheduler<32>;
+
+    struct Counter : Sched::Task {
+        explicit Counter(std::uint8_t prio = 0) : Sched::Task(&step, prio) {}
+        static void step(Sched::Task& t) { static_cast<Counter&>(t).count++; }
+        std::uint64_t count = 0;
+    };
+
+    // sleeps for zero time, going through the sleep list at every step
+    struct Sleeper : Sched::Task {
+        explicit Sleeper(Sched& s) : Sched::Task(&step), s(s) {}
+        static void step(Sched::Task& t) {
+            auto& self = static_cast<Sleeper&>(t);
+            self.s.sleep_for(self, Sched::duration::zero());
+        }
+        Sched& s;
+    };
+
+}
+
+int main() {
+
+    constexpr int kSteps = 10000000;
+
+    for (int tasks : { 1, 16, 256 }) {
+        Sched sched;
+        // every task at the same priority : each step is a full switch
+        std::vector<Counter> counters(tasks);
+        for (auto& c : counters) sched.ready(c);
+        const double ms = bench::measure([&] {
+            for (int i = 0; i < kSteps; i++) sched.run_once();
+        });
+        char name[64];
+        std::snprintf(name, sizeof(name), "round robin, %d tasks", tasks);
+        bench::report(name, ms, kSteps);
+    }
+
+    {
+        Sched sched;
+        std::vector<Sleeper> sleepers(16, Sleeper(sched));
+        for (auto& s : sleepers) sched.ready(s);
+        const double ms = bench::measure([&] {
+            for (int i = 0; i < kSteps / 10; i++) sched.run_once();
+        });
+        bench::report("sleep / wake, 16 tasks", ms, kSteps / 10);
+    }
+
+    return 0;
+}
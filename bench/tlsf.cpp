@@ -0,0 +1,81 @@
+#include "ulink_tlsf.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+    struct Latency {
+        double worst = 0;
+        double total = 0;
+        std::size_t count = 0;
+
+        template<typename F>
+        auto time(F&& f) {
+            const auto start = std::chrono::steady_clock::now();
+            auto r = f();
+            const auto stop = std::chrono::steady_clock::now();
+            const double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+            worst = std::max(worst, ns);
+            total += ns;
+            count++;
+            return r;
+        }
+
+        void print(const char* name) const {
+            std::printf("%-28s mean %8.1f ns   worst %10.1f ns\n", name, total / static_cast<double>(count), worst);
+        }
+    };
+
+    // same random sequence of allocations and frees for every allocator
+    template<typename alloc_t, typename free_t>
+    void run(const char* name, alloc_t alloc, free_t release) {
+
+        constexpr int kSteps = 1000000;
+        constexpr std::size_t kLive = 4096;
+
+        std::mt19937 rng(42);
+        std::vector<void*> live(kLive, nullptr);
+        Latency a;
+        Latency f;
+
+        for (int step = 0; step < kSteps; step++) {
+            auto& slot = live[rng() % kLive];
+            if (slot) {
+                void* p = slot;
+                f.time([&] { release(p); return 0; });
+                slot = nullptr;
+            }
+            else {
+                const std::size_t size = 16 + rng() % 4096;
+                slot = a.time([&] { return alloc(size); });
+            }
+        }
+
+        for (void* p : live) {
+            if (p) release(p);
+        }
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s allocate", name);
+        a.print(label);
+        std::snprintf(label, sizeof(label), "%s deallocate", name);
+        f.print(label);
+    }
+
+}
+
+int main() {
+
+    static unsigned char region[64 * 1024 * 1024];
+    ulink::Tlsf heap(region, sizeof(region));
+
+    run("ulink::Tlsf", [&] (std::size_t s) { return heap.allocate(s); }, [&] (void* p) { heap.deallocate(p); });
+    run("malloc", [] (std::size_t s) { return std::malloc(s); }, [] (void* p) { std::free(p); });
+
+    return 0;
+}
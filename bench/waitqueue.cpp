@@ -0,0 +1,70 @@
+#include "bench.hpp"
+
+#if defined(__linux__)
+
+#include "ulink_waitqueue.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+    constexpr int kRounds = 200000;
+
+    // two threads passing a token back and forth, every hand-off blocks
+    template<typename wait_t, typename notify_t>
+    double pingPong(std::mutex& m, int& turn, wait_t wait, notify_t notify) {
+        return bench::measure([&] {
+            std::thread pong([&] {
+                for (int i = 0; i < kRounds; i++) {
+                    std::unique_lock<std::mutex> lock(m);
+                    while (turn != 1) wait(lock);
+                    turn = 0;
+                    lock.unlock();
+                    notify();
+                }
+            });
+            for (int i = 0; i < kRounds; i++) {
+                std::unique_lock<std::mutex> lock(m);
+                while (turn != 0) wait(lock);
+                turn = 1;
+                lock.unlock();
+                notify();
+            }
+            pong.join();
+        });
+    }
+
+}
+
+int main() {
+
+    {
+        std::mutex m;
+        int turn = 0;
+        std::condition_variable cv;
+        const double ms = pingPong(m, turn,
+            [&] (std::unique_lock<std::mutex>& lock) { cv.wait(lock); },
+            [&] { cv.notify_one(); });
+        bench::report("std::condition_variable ping-pong", ms, 2 * kRounds);
+    }
+
+    {
+        std::mutex m;
+        int turn = 0;
+        ulink::WaitQueue q;
+        const double ms = pingPong(m, turn,
+            [&] (std::unique_lock<std::mutex>& lock) { q.wait(lock); },
+            [&] { q.notify_one(); });
+        bench::report("ulink::WaitQueue ping-pong", ms, 2 * kRounds);
+    }
+
+    return 0;
+}
+
+#else
+
+int main() { return 0; }
+
+#endif
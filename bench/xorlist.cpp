@@ -0,0 +1,82 @@
+#include "bench.hpp"
+
+#include "ulink.hpp"
+#include "ulink_xorlist.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+    struct ListItem : ulink::Node<ListItem> {
+        int value;
+    };
+
+    struct XorItem : ulink::XorNode<XorItem> {
+        int value;
+    };
+
+    template<typename item_t, typename list_t>
+    void run(const char* name, std::size_t count, bool shuffled) {
+
+        std::vector<item_t> items(count);
+        std::vector<std::size_t> order(count);
+        for (std::size_t i = 0; i < count; i++) {
+            items[i].value = static_cast<int>(i);
+            order[i] = i;
+        }
+        if (shuffled) {
+            std::shuffle(order.begin(), order.end(), std::mt19937(42));
+        }
+
+        list_t list;
+        for (auto i : order) {
+            list.push_back(items[i]);
+        }
+
+        constexpr int passes = 10;
+        volatile long long sink = 0;
+
+        char label[64];
+
+        std::snprintf(label, sizeof(label), "%s forward%s", name, shuffled ? " shuffled" : "");
+        bench::report(label, bench::measure([&] {
+            for (int p = 0; p < passes; p++) {
+                long long sum = 0;
+                for (auto& n : list) {
+                    sum += n.value;
+                }
+                sink = sink + sum;
+            }
+        }), count * passes);
+
+        std::snprintf(label, sizeof(label), "%s reverse%s", name, shuffled ? " shuffled" : "");
+        bench::report(label, bench::measure([&] {
+            for (int p = 0; p < passes; p++) {
+                long long sum = 0;
+                for (auto it = list.rbegin(); it != list.rend(); ++it) {
+                    sum += it->value;
+                }
+                sink = sink + sum;
+            }
+        }), count * passes);
+    }
+
+}
+
+int main() {
+
+    constexpr std::size_t count = 1 << 20;
+
+    std::printf("node size : List %zu bytes, XorList %zu bytes, %zu nodes : %zu KiB vs %zu KiB\n",
+        sizeof(ListItem), sizeof(XorItem), count,
+        sizeof(ListItem) * count / 1024, sizeof(XorItem) * count / 1024);
+
+    for (bool shuffled : { false, true }) {
+        run<ListItem, ulink::List<ListItem>>("List", count, shuffled);
+        run<XorItem, ulink::XorList<XorItem>>("XorList", count, shuffled);
+    }
+
+    return 0;
+}
@@ -29,8 +29,16 @@
 
 #include <cstddef>
 #include <csignal>
+#include <iterator>
 #include <type_traits>
 
+// lists and nodes can be built and walked in constant expressions from C++20
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201907L
+#define ULINK_CONSTEXPR constexpr
+#else
+#define ULINK_CONSTEXPR
+#endif
+
 namespace ulink {
 
     // forward declaration
@@ -41,7 +49,82 @@ namespace ulink {
     class List;
 
     template<typename node_t>
-    void swap(List<node_t>& lhs, List<node_t>& rhs) noexcept;
+    ULINK_CONSTEXPR void swap(List<node_t>& lhs, List<node_t>& rhs) noexcept;
+
+    namespace detail {
+
+        // stable bottom-up merge sort of a null terminated chain, no
+        // allocation, next(n) returns a reference to the link of "n"
+        template<typename link_t, typename next_t, typename less_t>
+        ULINK_CONSTEXPR link_t* sortChain(link_t* head, next_t next, less_t less) {
+
+            if (!head) {
+                return nullptr;
+            }
+
+            for (std::size_t runSize = 1;; runSize *= 2) {
+
+                link_t* p = head;
+                link_t* tail = nullptr;
+                std::size_t merges = 0;
+
+                head = nullptr;
+
+                while (p) {
+
+                    merges++;
+
+                    // the second run starts "runSize" nodes after the first one
+                    link_t* q = p;
+                    std::size_t pSize = 0;
+                    while (pSize < runSize && q) {
+                        pSize++;
+                        q = next(q);
+                    }
+                    std::size_t qSize = runSize;
+
+                    while (pSize > 0 || (qSize > 0 && q)) {
+
+                        link_t* e = nullptr;
+
+                        if (pSize == 0) {
+                            e = q;
+                            q = next(q);
+                            qSize--;
+                        }
+                        else if (qSize == 0 || !q || !less(q, p)) {
+                            e = p;
+                            p = next(p);
+                            pSize--;
+                        }
+                        else {
+                            e = q;
+                            q = next(q);
+                            qSize--;
+                        }
+
+                        if (tail) {
+                            next(tail) = e;
+                        }
+                        else {
+                            head = e;
+                        }
+
+                        tail = e;
+                    }
+
+                    p = q;
+                }
+
+                next(tail) = nullptr;
+
+                if (merges <= 1) {
+                    return head;
+                }
+            }
+        }
+
+    }
 
     // non-owning doubly linkled list
     template<typename node_t>
@@ -52,31 +135,82 @@ namespace ulink {
             "Node type error"
             );
 
+        using hook_t = Node<node_t>;
+
+        template<bool is_forward>
+        struct ConstIterator;
+
+        // bidirectional iterators, "is_forward" false walks backward
         template<bool is_forward>
         struct Iterator {
-            Iterator(node_t* n) : mNode(n) {}
-            node_t& operator*() { return *mNode; }
-            Iterator& operator++() { mNode = is_forward ? mNode->next : mNode->prev; return *this; }
-            Iterator& operator--() { mNode = is_forward ? mNode->prev : mNode->next; return *this; }
-            bool operator !=(const Iterator& it) const { return (mNode != it.mNode); }
-            bool operator ==(const Iterator& it) const { return (mNode == it.mNode); }
-            node_t* operator ->() { return mNode; }
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = node_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = node_t*;
+            using reference = node_t&;
+            Iterator() = default;
+            ULINK_CONSTEXPR Iterator(hook_t* n) : mNode(n) {}
+            ULINK_CONSTEXPR node_t& operator*() const { return static_cast<node_t&>(*mNode); }
+            ULINK_CONSTEXPR node_t* operator ->() const { return static_cast<node_t*>(mNode); }
+            ULINK_CONSTEXPR Iterator& operator++() { mNode = is_forward ? mNode->next : mNode->prev; return *this; }
+            ULINK_CONSTEXPR Iterator& operator--() { mNode = is_forward ? mNode->prev : mNode->next; return *this; }
+            ULINK_CONSTEXPR Iterator operator++(int) { Iterator it = *this; ++(*this); return it; }
+            ULINK_CONSTEXPR Iterator operator--(int) { Iterator it = *this; --(*this); return it; }
+            ULINK_CONSTEXPR bool operator !=(const Iterator& it) const { return (mNode != it.mNode); }
+            ULINK_CONSTEXPR bool operator ==(const Iterator& it) const { return (mNode == it.mNode); }
+            ULINK_CONSTEXPR operator ConstIterator<is_forward>() const { return ConstIterator<is_forward>(mNode); }
         private:
-            node_t* mNode;
+            friend class List;
+            hook_t* mNode = nullptr;
         };
 
         template<bool is_forward>
         struct ConstIterator {
-            ConstIterator(const node_t* n) : mNode(n) {}
-            ConstIterator(Iterator<is_forward>& it) : mNode(it.mNode) {}
-            const node_t& operator*() const { return *mNode; }
-            ConstIterator& operator++() { mNode = is_forward ? mNode->next : mNode->prev; return *this; }
-            ConstIterator& operator--() { mNode = is_forward ? mNode->prev : mNode->next; return *this; }
-            bool operator !=(const ConstIterator& it) const { return (mNode != it.mNode); }
-            bool operator ==(const ConstIterator& it) const { return (mNode == it.mNode); }
-            const node_t* operator ->() const { return mNode; }
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = node_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const node_t*;
+            using reference = const node_t&;
+            ConstIterator() = default;
+            ULINK_CONSTEXPR ConstIterator(const hook_t* n) : mNode(n) {}
+            ULINK_CONSTEXPR const node_t& operator*() const { return static_cast<const node_t&>(*mNode); }
+            ULINK_CONSTEXPR const node_t* operator ->() const { return static_cast<const node_t*>(mNode); }
+            ULINK_CONSTEXPR ConstIterator& operator++() { mNode = is_forward ? mNode->next : mNode->prev; return *this; }
+            ULINK_CONSTEXPR ConstIterator& operator--() { mNode = is_forward ? mNode->prev : mNode->next; return *this; }
+            ULINK_CONSTEXPR ConstIterator operator++(int) { ConstIterator it = *this; ++(*this); return it; }
+            ULINK_CONSTEXPR ConstIterator operator--(int) { ConstIterator it = *this; --(*this); return it; }
+            ULINK_CONSTEXPR bool operator !=(const ConstIterator& it) const { return (mNode != it.mNode); }
+            ULINK_CONSTEXPR bool operator ==(const ConstIterator& it) const { return (mNode == it.mNode); }
+        private:
+            const hook_t* mNode = nullptr;
+        };
+
+        // forward iterator that reads the following node in advance, so
+        // the node it points at may be removed during the walk
+        struct StableIterator {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = node_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = node_t*;
+            using reference = node_t&;
+            StableIterator() = default;
+            ULINK_CONSTEXPR StableIterator(hook_t* n) : mNode(n), mNext(n->next) {}
+            ULINK_CONSTEXPR node_t& operator*() const { return static_cast<node_t&>(*mNode); }
+            ULINK_CONSTEXPR node_t* operator ->() const { return static_cast<node_t*>(mNode); }
+            ULINK_CONSTEXPR StableIterator& operator++() { mNode = mNext; mNext = mNode->next; return *this; }
+            ULINK_CONSTEXPR StableIterator operator++(int) { StableIterator it = *this; ++(*this); return it; }
+            ULINK_CONSTEXPR bool operator !=(const StableIterator& it) const { return (mNode != it.mNode); }
+            ULINK_CONSTEXPR bool operator ==(const StableIterator& it) const { return (mNode == it.mNode); }
         private:
-            const node_t* mNode;
+            hook_t* mNode = nullptr;
+            hook_t* mNext = nullptr;
+        };
+
+        struct StableRange {
+            ULINK_CONSTEXPR StableIterator begin() const { return mBegin; }
+            ULINK_CONSTEXPR StableIterator end() const { return mEnd; }
+            StableIterator mBegin;
+            StableIterator mEnd;
         };
 
     public:
@@ -85,74 +219,111 @@ namespace ulink {
         using const_iterator = ConstIterator<true>;
         using reverse_iterator = Iterator<false>;
         using const_reverse_iterator = ConstIterator<false>;
+        using stable_iterator = StableIterator;
         using value_type = node_t;
         using size_type = std::size_t;
         using reference = value_type&;
         using const_reference = const value_type&;
 
-        List();
+        ULINK_CONSTEXPR List();
 
         List(const List<node_t>& other) = delete;
         List& operator=(const List<node_t>& other) = delete;
 
-        static void swap(List& lhs, List& rhs) noexcept;
+        static ULINK_CONSTEXPR void swap(List& lhs, List& rhs) noexcept;
+
+        ULINK_CONSTEXPR iterator begin();
+        ULINK_CONSTEXPR iterator end();
+
+        ULINK_CONSTEXPR const_iterator begin() const;
+        ULINK_CONSTEXPR const_iterator end() const;
+
+        ULINK_CONSTEXPR reverse_iterator rbegin();
+        ULINK_CONSTEXPR reverse_iterator rend();
+
+        ULINK_CONSTEXPR const_reverse_iterator rbegin() const;
+        ULINK_CONSTEXPR const_reverse_iterator rend() const;
+
+        ULINK_CONSTEXPR stable_iterator stable_begin();
+        ULINK_CONSTEXPR stable_iterator stable_end();
 
-        iterator begin();
-        iterator end();
+        // "for (auto& n : list.stable()) if (...) n.remove();"
+        ULINK_CONSTEXPR StableRange stable() { return { stable_begin(), stable_end() }; }
 
-        const_iterator begin() const;
-        const_iterator end() const;
+        ULINK_CONSTEXPR reference front();
+        ULINK_CONSTEXPR reference back();
 
-        reverse_iterator rbegin();
-        reverse_iterator rend();
+        ULINK_CONSTEXPR const_reference front() const;
+        ULINK_CONSTEXPR const_reference back() const;
 
-        const_reverse_iterator rbegin() const;
-        const_reverse_iterator rend() const;
+        ULINK_CONSTEXPR size_type size() const;
+        ULINK_CONSTEXPR bool empty() const;
+        ULINK_CONSTEXPR void clear();
 
-        reference front();
-        reference back();
+        ULINK_CONSTEXPR void push_front(reference node);
+        ULINK_CONSTEXPR void push_back(reference node);
+        ULINK_CONSTEXPR void splice(iterator pos, List& other);
+        ULINK_CONSTEXPR void splice(iterator pos, List& other, iterator it);
+        ULINK_CONSTEXPR void splice(iterator pos, List& other, iterator first, iterator last);
 
-        const_reference front() const;
-        const_reference back() const;
+        ULINK_CONSTEXPR void pop_front();
+        ULINK_CONSTEXPR void pop_back();
 
-        size_type size() const;
-        bool empty() const;
-        void clear();
+        ULINK_CONSTEXPR void insert_before(iterator pos, reference node);
+        ULINK_CONSTEXPR void insert_after(iterator pos, reference node);
 
-        void push_front(reference node);
-        void push_back(reference node);
-        void splice(iterator pos, List& other);
-        void splice(iterator pos, List& other, iterator it);
-        void splice(iterator pos, List& other, iterator first, iterator last);
+        // insert after the last node that does not compare greater,
+        // searching from the back
+        template<typename compare_t>
+        ULINK_CONSTEXPR iterator insert_sorted(reference node, compare_t comp);
 
-        void pop_front();
-        void pop_back();
+        // same as insert_sorted but the search starts at "hint" and walks
+        // toward the insertion point, O(1) for nearly sorted input
+        template<typename compare_t>
+        ULINK_CONSTEXPR iterator insert_sorted_hint(iterator hint, reference node, compare_t comp);
 
-        void insert_before(iterator pos, reference node);
-        void insert_after(iterator pos, reference node);
+        // returns the iterator following "pos", erasing end() does nothing
+        ULINK_CONSTEXPR iterator erase(iterator pos);
 
-        void erase(iterator pos);
+        // returns "last"
+        ULINK_CONSTEXPR iterator erase(iterator first, iterator last);
 
-        ~List() { clear(); }
+        // erases every node for which pred(node) is true, returns their count
+        template<typename pred_t>
+        ULINK_CONSTEXPR size_type erase_if(pred_t pred);
+
+        // stable, both lists sorted, "other" is left empty
+        template<typename compare_t>
+        ULINK_CONSTEXPR void merge(List& other, compare_t comp);
+
+        // stable bottom-up merge sort, no allocation
+        template<typename compare_t>
+        ULINK_CONSTEXPR void sort(compare_t comp);
+
+        ULINK_CONSTEXPR ~List() { clear(); }
 
     private:
 
-        void insertAfter(Node<value_type>& pos, reference node);
-        void insertBefore(Node<value_type>& pos, reference node);
+        // the links are hook pointers, the sentinels being bare hooks that
+        // are never converted to node_t
+        static ULINK_CONSTEXPR node_t* value(hook_t* n) { return static_cast<node_t*>(n); }
 
-        Node<value_type> mStartNode;
-        Node<value_type> mEndNode;
+        ULINK_CONSTEXPR void insertAfter(hook_t& pos, hook_t& node);
+        ULINK_CONSTEXPR void insertBefore(hook_t& pos, hook_t& node);
+
+        hook_t mStartNode;
+        hook_t mEndNode;
 
     };
 
     template<typename node_t>
-    List<node_t>::List() {
-        mStartNode.next = static_cast<value_type*>(&mEndNode);
-        mEndNode.prev = static_cast<value_type*>(&mStartNode);
+    ULINK_CONSTEXPR List<node_t>::List() {
+        mStartNode.next = &mEndNode;
+        mEndNode.prev = &mStartNode;
     }
 
     template<typename node_t>
-    void List<node_t>::swap(List<node_t>& lhs, List<node_t>& rhs) noexcept {
+    ULINK_CONSTEXPR void List<node_t>::swap(List<node_t>& lhs, List<node_t>& rhs) noexcept {
 
         if (&lhs == &rhs) {
             return;
@@ -163,113 +334,123 @@ namespace ulink {
         auto* rhsFirst = rhs.mStartNode.next;
         auto* rhsLast = rhs.mEndNode.prev;
 
-        const bool lhsEmpty = (lhsFirst == static_cast<value_type*>(&lhs.mEndNode));
-        const bool rhsEmpty = (rhsFirst == static_cast<value_type*>(&rhs.mEndNode));
+        const bool lhsEmpty = (lhsFirst == &lhs.mEndNode);
+        const bool rhsEmpty = (rhsFirst == &rhs.mEndNode);
 
         if (rhsEmpty) {
-            lhs.mStartNode.next = static_cast<value_type*>(&lhs.mEndNode);
-            lhs.mEndNode.prev = static_cast<value_type*>(&lhs.mStartNode);
+            lhs.mStartNode.next = &lhs.mEndNode;
+            lhs.mEndNode.prev = &lhs.mStartNode;
         }
         else {
             lhs.mStartNode.next = rhsFirst;
             lhs.mEndNode.prev = rhsLast;
-            rhsFirst->prev = static_cast<value_type*>(&lhs.mStartNode);
-            rhsLast->next = static_cast<value_type*>(&lhs.mEndNode);
+            rhsFirst->prev = &lhs.mStartNode;
+            rhsLast->next = &lhs.mEndNode;
         }
 
         if (lhsEmpty) {
-            rhs.mStartNode.next = static_cast<value_type*>(&rhs.mEndNode);
-            rhs.mEndNode.prev = static_cast<value_type*>(&rhs.mStartNode);
+            rhs.mStartNode.next = &rhs.mEndNode;
+            rhs.mEndNode.prev = &rhs.mStartNode;
         }
         else {
             rhs.mStartNode.next = lhsFirst;
             rhs.mEndNode.prev = lhsLast;
-            lhsFirst->prev = static_cast<value_type*>(&rhs.mStartNode);
-            lhsLast->next = static_cast<value_type*>(&rhs.mEndNode);
+            lhsFirst->prev = &rhs.mStartNode;
+            lhsLast->next = &rhs.mEndNode;
         }
     }
 
     template<typename node_t>
-    void swap(List<node_t>& lhs, List<node_t>& rhs) noexcept {
+    ULINK_CONSTEXPR void swap(List<node_t>& lhs, List<node_t>& rhs) noexcept {
         List<node_t>::swap(lhs, rhs);
     }
 
     template<typename node_t>
-    typename List<node_t>::iterator List<node_t>::begin() {
+    ULINK_CONSTEXPR typename List<node_t>::iterator List<node_t>::begin() {
         return iterator(mStartNode.next);
     }
 
     template<typename node_t>
-    typename List<node_t>::iterator List<node_t>::end() {
-        return iterator(static_cast<node_t*>(&mEndNode));
+    ULINK_CONSTEXPR typename List<node_t>::iterator List<node_t>::end() {
+        return iterator(&mEndNode);
     }
 
     template<typename node_t>
-    typename List<node_t>::const_iterator List<node_t>::begin() const {
+    ULINK_CONSTEXPR typename List<node_t>::const_iterator List<node_t>::begin() const {
         return const_iterator(mStartNode.next);
     }
 
     template<typename node_t>
-    typename List<node_t>::const_iterator List<node_t>::end() const {
+    ULINK_CONSTEXPR typename List<node_t>::const_iterator List<node_t>::end() const {
         return const_iterator(&mEndNode);
     }
 
     template<typename node_t>
-    typename List<node_t>::reverse_iterator List<node_t>::rbegin() {
+    ULINK_CONSTEXPR typename List<node_t>::reverse_iterator List<node_t>::rbegin() {
         return reverse_iterator(mEndNode.prev);
     }
 
     template<typename node_t>
-    typename List<node_t>::reverse_iterator List<node_t>::rend() {
-        return reverse_iterator(static_cast<node_t*>(&mStartNode));
+    ULINK_CONSTEXPR typename List<node_t>::reverse_iterator List<node_t>::rend() {
+        return reverse_iterator(&mStartNode);
     }
 
     template<typename node_t>
-    typename List<node_t>::const_reverse_iterator List<node_t>::rbegin() const {
+    ULINK_CONSTEXPR typename List<node_t>::const_reverse_iterator List<node_t>::rbegin() const {
         return const_reverse_iterator(mEndNode.prev);
     }
 
     template<typename node_t>
-    typename List<node_t>::const_reverse_iterator List<node_t>::rend() const {
+    ULINK_CONSTEXPR typename List<node_t>::const_reverse_iterator List<node_t>::rend() const {
         return const_reverse_iterator(&mStartNode);
     }
 
     template<typename node_t>
-    node_t& List<node_t>::front() {
+    ULINK_CONSTEXPR typename List<node_t>::stable_iterator List<node_t>::stable_begin() {
+        return stable_iterator(mStartNode.next);
+    }
+
+    template<typename node_t>
+    ULINK_CONSTEXPR typename List<node_t>::stable_iterator List<node_t>::stable_end() {
+        return stable_iterator(&mEndNode);
+    }
+
+    template<typename node_t>
+    ULINK_CONSTEXPR node_t& List<node_t>::front() {
         if (empty()) {
             std::raise(SIGSEGV);
         }
-        return *mStartNode.next;
+        return *value(mStartNode.next);
     }
 
     template<typename node_t>
-    node_t& List<node_t>::back() {
+    ULINK_CONSTEXPR node_t& List<node_t>::back() {
         if (empty()) {
             std::raise(SIGSEGV);
         }
-        return *mEndNode.prev;
+        return *value(mEndNode.prev);
     }
 
     template<typename node_t>
-    const node_t& List<node_t>::front() const {
+    ULINK_CONSTEXPR const node_t& List<node_t>::front() const {
         if (empty()) {
             std::raise(SIGSEGV);
         }
-        return *mStartNode.next;
+        return *value(mStartNode.next);
     }
 
     template<typename node_t>
-    const node_t& List<node_t>::back() const {
+    ULINK_CONSTEXPR const node_t& List<node_t>::back() const {
         if (empty()) {
             std::raise(SIGSEGV);
         }
-        return *mEndNode.prev;
+        return *value(mEndNode.prev);
     }
 
     template<typename node_t>
-    typename List<node_t>::size_type List<node_t>::size() const {
+    ULINK_CONSTEXPR typename List<node_t>::size_type List<node_t>::size() const {
         size_type outSize = 0;
-        auto* n = mStartNode.next;
+        const hook_t* n = mStartNode.next;
         while (n != &mEndNode) {
             outSize++;
             n = n->next;
@@ -278,32 +459,32 @@ namespace ulink {
     }
 
     template<typename node_t>
-    bool List<node_t>::empty() const {
+    ULINK_CONSTEXPR bool List<node_t>::empty() const {
         return (mStartNode.next == &mEndNode);
     }
 
     template<typename node_t>
-    void List<node_t>::clear() {
+    ULINK_CONSTEXPR void List<node_t>::clear() {
         auto* n = mStartNode.next;
         while (n != &mEndNode) {
             auto* t = n;
             n = n->next;
-            t->remove();
+            value(t)->remove();
         }
     }
 
     template<typename node_t>
-    void List<node_t>::push_front(reference node) {
+    ULINK_CONSTEXPR void List<node_t>::push_front(reference node) {
         insertAfter(mStartNode, node);
     }
 
     template<typename node_t>
-    void List<node_t>::push_back(reference node) {
+    ULINK_CONSTEXPR void List<node_t>::push_back(reference node) {
         insertBefore(mEndNode, node);
     }
 
     template<typename node_t>
-    void List<node_t>::splice(iterator pos, List<node_t>& other) {
+    ULINK_CONSTEXPR void List<node_t>::splice(iterator pos, List<node_t>& other) {
 
         if (&other == this || other.empty()) {
             return;
@@ -312,24 +493,22 @@ namespace ulink {
         // splice the whole "other" range before the target position
         auto* first = other.mStartNode.next;
         auto* last = other.mEndNode.prev;
-        auto* posValue = (&(*pos) == &mEndNode)
-            ? static_cast<value_type*>(&mEndNode)
-            : &(*pos);
+        auto* posNode = pos.mNode;
 
-        // hook other range before posValue
-        auto* before = posValue->prev;
+        // hook other range before posNode
+        auto* before = posNode->prev;
         before->next = first;
         first->prev = before;
-        last->next = posValue;
-        posValue->prev = last;
+        last->next = posNode;
+        posNode->prev = last;
 
         // leave "other" empty
-        other.mStartNode.next = static_cast<value_type*>(&other.mEndNode);
-        other.mEndNode.prev = static_cast<value_type*>(&other.mStartNode);
+        other.mStartNode.next = &other.mEndNode;
+        other.mEndNode.prev = &other.mStartNode;
     }
 
     template<typename node_t>
-    void List<node_t>::splice(iterator pos, List<node_t>& other, iterator it) {
+    ULINK_CONSTEXPR void List<node_t>::splice(iterator pos, List<node_t>& other, iterator it) {
 
         if (it == other.end()) {
             return;
@@ -337,14 +516,14 @@ namespace ulink {
 
         // If moving inside the same list and inserting before the same node, no-op
         if (&other == this) {
-            if (&(*it) == &(*pos)) return;
+            if (it == pos) return;
         }
 
         insert_before(pos, *it);
     }
 
     template<typename node_t>
-    void List<node_t>::splice(iterator pos, List<node_t>& other, iterator first, iterator last) {
+    ULINK_CONSTEXPR void List<node_t>::splice(iterator pos, List<node_t>& other, iterator first, iterator last) {
 
         if (first == last) {
             return;
@@ -353,13 +532,13 @@ namespace ulink {
         if (&other == this) {
             // If pos lies inside the moved range, do nothing (avoid undefined behavior)
             for (auto it = first; it != last; ++it) {
-                if (&(*it) == &(*pos)) return;
+                if (it == pos) return;
             }
         }
 
         // nodes for the range [first, last)
-        auto* firstNode = first.operator->();
-        auto* lastNode = last.operator->(); // node after the moved range
+        auto* firstNode = first.mNode;
+        auto* lastNode = last.mNode; // node after the moved range
 
         // detach range from other
         auto* prevFirst = firstNode->prev;
@@ -369,80 +548,204 @@ namespace ulink {
         lastNode->prev = prevFirst;
 
         // compute insertion point
-        auto* posValue = (&(*pos) == &mEndNode) ? static_cast<value_type*>(&mEndNode) : &(*pos);
+        auto* posNode = pos.mNode;
 
-        // hook range before posValue
-        auto* before = posValue->prev;
+        // hook range before posNode
+        auto* before = posNode->prev;
         before->next = firstNode;
         firstNode->prev = before;
-        lastPrev->next = posValue;
-        posValue->prev = lastPrev;
+        lastPrev->next = posNode;
+        posNode->prev = lastPrev;
 
     }
 
     template<typename node_t>
-    void List<node_t>::pop_front() {
+    ULINK_CONSTEXPR void List<node_t>::pop_front() {
         if (empty()) {
             return;
         }
-        mStartNode.next->remove();
+        value(mStartNode.next)->remove();
     }
 
     template<typename node_t>
-    void List<node_t>::pop_back() {
+    ULINK_CONSTEXPR void List<node_t>::pop_back() {
         if (empty()) {
             return;
         }
-        mEndNode.prev->remove();
+        value(mEndNode.prev)->remove();
     }
 
     template<typename node_t>
-    void List<node_t>::insert_before(iterator pos, reference node) {
+    ULINK_CONSTEXPR void List<node_t>::insert_before(iterator pos, reference node) {
 
         if (pos == begin()) {
             insertAfter(mStartNode, node);
         }
         else {
-            insertBefore(*pos, node);
+            insertBefore(*pos.mNode, node);
         }
 
     }
 
     template<typename node_t>
-    void List<node_t>::insert_after(iterator pos, reference node) {
+    ULINK_CONSTEXPR void List<node_t>::insert_after(iterator pos, reference node) {
 
         if (pos == end()) {
             insertBefore(mEndNode, node);
         }
         else {
-            insertAfter(*pos, node);
+            insertAfter(*pos.mNode, node);
         }
 
     }
 
     template<typename node_t>
-    void List<node_t>::erase(iterator pos) {
-        if (pos == end()) { // not ideal...
-            pop_back();
+    template<typename compare_t>
+    ULINK_CONSTEXPR typename List<node_t>::iterator List<node_t>::insert_sorted(reference node, compare_t comp) {
+        return insert_sorted_hint(end(), node, comp);
+    }
+
+    template<typename node_t>
+    template<typename compare_t>
+    ULINK_CONSTEXPR typename List<node_t>::iterator List<node_t>::insert_sorted_hint(iterator hint, reference node, compare_t comp) {
+
+        // the hint must not be the node being (re)inserted
+        if (hint == iterator(&node)) {
+            ++hint;
+        }
+
+        node.remove();
+
+        auto pos = hint;
+
+        if (pos != end() && !comp(node, *pos)) {
+            // walk forward past every node not greater than "node"
+            do {
+                ++pos;
+            } while (pos != end() && !comp(node, *pos));
         }
         else {
-            (*pos).remove();
+            // walk backward while the previous node is greater than "node"
+            while (pos != begin()) {
+                auto prev = pos;
+                --prev;
+                if (!comp(node, *prev)) {
+                    break;
+                }
+                pos = prev;
+            }
+        }
+
+        insert_before(pos, node);
+
+        return iterator(&node);
+    }
+
+    template<typename node_t>
+    ULINK_CONSTEXPR typename List<node_t>::iterator List<node_t>::erase(iterator pos) {
+        if (pos == end()) {
+            return pos;
         }
+        auto next = pos;
+        ++next;
+        (*pos).remove();
+        return next;
     }
 
     template<typename node_t>
-    void List<node_t>::insertAfter(Node<node_t>& pos, reference node) {
-        node.remove();
-        node.prev = static_cast<value_type*>(&pos);
+    ULINK_CONSTEXPR typename List<node_t>::iterator List<node_t>::erase(iterator first, iterator last) {
+        while (first != last) {
+            auto next = first;
+            ++next;
+            (*first).remove();
+            first = next;
+        }
+        return last;
+    }
+
+    template<typename node_t>
+    template<typename pred_t>
+    ULINK_CONSTEXPR typename List<node_t>::size_type List<node_t>::erase_if(pred_t pred) {
+        size_type count = 0;
+        for (auto& node : stable()) {
+            if (pred(node)) {
+                node.remove();
+                count++;
+            }
+        }
+        return count;
+    }
+
+    template<typename node_t>
+    template<typename compare_t>
+    ULINK_CONSTEXPR void List<node_t>::merge(List<node_t>& other, compare_t comp) {
+
+        if (&other == this) {
+            return;
+        }
+
+        auto pos = begin();
+
+        while (!other.empty()) {
+
+            auto& node = other.front();
+
+            // nodes of this list go first on equality
+            while (pos != end() && !comp(node, *pos)) {
+                ++pos;
+            }
+
+            if (pos == end()) {
+                splice(pos, other);
+                return;
+            }
+
+            insert_before(pos, node);
+        }
+    }
+
+    template<typename node_t>
+    template<typename compare_t>
+    ULINK_CONSTEXPR void List<node_t>::sort(compare_t comp) {
+
+        if (empty()) {
+            return;
+        }
+
+        // sort the chain of "next" links, then rebuild the "prev" links
+        mEndNode.prev->next = nullptr;
+
+        hook_t* head = detail::sortChain(
+            mStartNode.next,
+            [] (hook_t* n) -> hook_t*& { return n->next; },
+            [&comp] (hook_t* a, hook_t* b) { return comp(*value(a), *value(b)); }
+        );
+
+        hook_t* prev = &mStartNode;
+        mStartNode.next = head;
+
+        for (auto* n = head; n; n = n->next) {
+            n->prev = prev;
+            prev = n;
+        }
+
+        prev->next = &mEndNode;
+        mEndNode.prev = prev;
+    }
+
+    template<typename node_t>
+    ULINK_CONSTEXPR void List<node_t>::insertAfter(hook_t& pos, hook_t& node) {
+        value(&node)->remove();
+        node.prev = &pos;
         node.next = pos.next;
         node.next->prev = &node;
         pos.next = &node;
     }
 
     template<typename node_t>
-    void List<node_t>::insertBefore(Node<node_t>& pos, reference node) {
-        node.remove();
-        node.next = static_cast<value_type*>(&pos);
+    ULINK_CONSTEXPR void List<node_t>::insertBefore(hook_t& pos, hook_t& node) {
+        value(&node)->remove();
+        node.next = &pos;
         node.prev = pos.prev;
         node.prev->next = &node;
         pos.prev = &node;
@@ -454,23 +757,27 @@ namespace ulink {
     template<typename T>
     struct Node {
 
-        void remove();
+        ULINK_CONSTEXPR void remove();
 
-        bool isLinked() const;
+        ULINK_CONSTEXPR bool isLinked() const;
 
-        ~Node() { remove(); }
+        ULINK_CONSTEXPR ~Node() { remove(); }
 
     protected:
 
         template<typename node_t>
         friend class List;
 
-        T* prev = nullptr;
-        T* next = nullptr;
+        // following hook, for derived hooks walking the list themselves,
+        // nullptr past the end sentinel
+        static ULINK_CONSTEXPR Node* successor(const Node& n) { return n.next; }
+
+        Node* prev = nullptr;
+        Node* next = nullptr;
     };
 
     template<typename T>
-    void Node<T>::remove() {
+    ULINK_CONSTEXPR void Node<T>::remove() {
 
         if (prev) {
             prev->next = next;
@@ -484,7 +791,7 @@ namespace ulink {
     }
 
     template<typename T>
-    bool Node<T>::isLinked() const {
+    ULINK_CONSTEXPR bool Node<T>::isLinked() const {
         return (prev != nullptr);
     }
 
@@ -0,0 +1,246 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace ulink {
+
+    // binary buddy allocator over a caller-supplied region, blocks of
+    // 2^min_order to 2^max_order bytes
+    // each order has a ulink list of free blocks, a freed block is merged
+    // with its buddy by unlinking the buddy in O(1)
+    // one metadata byte per 2^min_order bytes is kept at the end of the
+    // region, so a region aligned on 2^max_order gives naturally aligned
+    // blocks
+    template<std::size_t min_order, std::size_t max_order>
+    class BuddyAllocator {
+
+        struct FreeBlock : Node<FreeBlock> {};
+
+        static_assert(min_order <= max_order, "invalid orders");
+        static_assert(max_order < sizeof(std::size_t) * 8, "max_order too large for size_t");
+        static_assert((std::size_t(1) << min_order) >= sizeof(FreeBlock), "min_order too small to hold a free list hook");
+
+    public:
+
+        using size_type = std::size_t;
+
+        struct Stats {
+            size_type total;        // bytes managed
+            size_type free;         // bytes in free blocks
+            size_type largest_free; // largest free block
+            size_type free_blocks;  // number of free blocks
+
+            // 0 when the largest free block is as large as the free memory
+            // allows, toward 1 when the free memory is scattered
+            double fragmentation() const {
+                const size_type best = (free < max_block_size) ? free : max_block_size;
+                return best ? 1.0 - static_cast<double>(largest_free) / static_cast<double>(best) : 0.0;
+            }
+        };
+
+        static constexpr size_type min_block_size = size_type(1) << min_order;
+        static constexpr size_type max_block_size = size_type(1) << max_order;
+
+        BuddyAllocator(void* region, size_type size);
+
+        BuddyAllocator(const BuddyAllocator& other) = delete;
+        BuddyAllocator& operator=(const BuddyAllocator& other) = delete;
+
+        // nullptr when no block of the required order is available
+        void* allocate(size_type size);
+
+        // ptr must come from this allocator or be nullptr
+        void deallocate(void* ptr);
+
+        // size of the block holding ptr
+        size_type usable_size(const void* ptr) const;
+
+        Stats stats() const;
+
+    private:
+
+        static constexpr std::uint8_t kFree = 0x80;
+        static constexpr std::size_t kOrderCount = max_order - min_order + 1;
+
+        void insertFree(size_type offset, std::size_t order);
+        FreeBlock* blockAt(size_type offset) const { return reinterpret_cast<FreeBlock*>(mBase + offset); }
+        std::uint8_t& metaOf(size_type offset) const { return mMeta[offset >> min_order]; }
+
+        List<FreeBlock> mFree[kOrderCount];
+        unsigned char* mBase = nullptr;
+        std::uint8_t* mMeta = nullptr;
+        size_type mSize = 0;
+
+    };
+
+    template<std::size_t min_order, std::size_t max_order>
+    BuddyAllocator<min_order, max_order>::BuddyAllocator(void* region, size_type size) {
+
+        auto start = reinterpret_cast<std::uintptr_t>(region);
+        const auto end = start + size;
+        start = (start + min_block_size - 1) & ~std::uintptr_t(min_block_size - 1);
+
+        if (end < start) {
+            return;
+        }
+
+        // every minimum block costs its bytes plus one metadata byte
+        const size_type count = (end - start) / (min_block_size + 1);
+
+        mBase = reinterpret_cast<unsigned char*>(start);
+        mSize = count << min_order;
+        mMeta = mBase + mSize;
+
+        for (size_type i = 0; i < count; i++) {
+            mMeta[i] = 0;
+        }
+
+        // cut the region into the largest aligned blocks that fit
+        size_type offset = 0;
+        while (offset + min_block_size <= mSize) {
+            std::size_t order = max_order;
+            while (order > min_order &&
+                ((offset & ((size_type(1) << order) - 1)) || offset + (size_type(1) << order) > mSize)) {
+                order--;
+            }
+            insertFree(offset, order);
+            offset += size_type(1) << order;
+        }
+    }
+
+    template<std::size_t min_order, std::size_t max_order>
+    void* BuddyAllocator<min_order, max_order>::allocate(size_type size) {
+
+        if (size == 0 || size > max_block_size) {
+            return nullptr;
+        }
+
+        std::size_t order = min_order;
+        while ((size_type(1) << order) < size) {
+            order++;
+        }
+
+        std::size_t k = order;
+        while (k <= max_order && mFree[k - min_order].empty()) {
+            k++;
+        }
+
+        if (k > max_order) {
+            return nullptr;
+        }
+
+        auto* block = &mFree[k - min_order].front();
+        block->remove();
+
+        const size_type offset = static_cast<size_type>(reinterpret_cast<unsigned char*>(block) - mBase);
+
+        // split, the upper halves go to the lower orders
+        while (k > order) {
+            k--;
+            insertFree(offset + (size_type(1) << k), k);
+        }
+
+        metaOf(offset) = static_cast<std::uint8_t>(order);
+
+        return block;
+    }
+
+    template<std::size_t min_order, std::size_t max_order>
+    void BuddyAllocator<min_order, max_order>::deallocate(void* ptr) {
+
+        if (!ptr) {
+            return;
+        }
+
+        size_type offset = static_cast<size_type>(static_cast<unsigned char*>(ptr) - mBase);
+        std::size_t order = metaOf(offset);
+
+        metaOf(offset) = 0;
+
+        while (order < max_order) {
+
+            const size_type buddy = offset ^ (size_type(1) << order);
+
+            if (buddy + (size_type(1) << order) > mSize ||
+                metaOf(buddy) != (kFree | order)) {
+                break;
+            }
+
+            blockAt(buddy)->remove();
+            metaOf(buddy) = 0;
+
+            if (buddy < offset) {
+                offset = buddy;
+            }
+
+            order++;
+        }
+
+        insertFree(offset, order);
+    }
+
+    template<std::size_t min_order, std::size_t max_order>
+    typename BuddyAllocator<min_order, max_order>::size_type BuddyAllocator<min_order, max_order>::usable_size(const void* ptr) const {
+        if (!ptr) {
+            return 0;
+        }
+        const auto offset = static_cast<size_type>(static_cast<const unsigned char*>(ptr) - mBase);
+        return size_type(1) << (metaOf(offset) & ~kFree);
+    }
+
+    template<std::size_t min_order, std::size_t max_order>
+    typename BuddyAllocator<min_order, max_order>::Stats BuddyAllocator<min_order, max_order>::stats() const {
+
+        Stats s { mSize, 0, 0, 0 };
+
+        for (std::size_t k = 0; k < kOrderCount; k++) {
+            const size_type count = mFree[k].size();
+            if (count) {
+                s.free += count << (k + min_order);
+                s.free_blocks += count;
+                s.largest_free = size_type(1) << (k + min_order);
+            }
+        }
+
+        return s;
+    }
+
+    template<std::size_t min_order, std::size_t max_order>
+    void BuddyAllocator<min_order, max_order>::insertFree(size_type offset, std::size_t order) {
+        auto* block = new (mBase + offset) FreeBlock;
+        mFree[order - min_order].push_front(*block);
+        metaOf(offset) = static_cast<std::uint8_t>(kFree | order);
+    }
+
+}
@@ -0,0 +1,210 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+namespace ulink {
+
+    // one piece of a BufferChain : a view on "length" bytes at "data"
+    // segments created by a split share the storage of the segment they
+    // come from, the reference count being kept on the owning segment,
+    // which must outlive the segments sharing its storage
+    struct Segment : Node<Segment> {
+
+        Segment() = default;
+        Segment(void* d, std::size_t l) : data(static_cast<unsigned char*>(d)), length(l) {}
+
+        // segment holding the reference count of the storage
+        Segment& owner() { return mOwner ? *mOwner : *this; }
+        const Segment& owner() const { return mOwner ? *mOwner : *this; }
+
+        void retain() { owner().mRefs++; }
+
+        // true when the last reference to the storage was released, a
+        // segment sharing the storage of another one is detached from it
+        bool release() {
+            Segment& o = owner();
+            mOwner = nullptr;
+            return --o.mRefs == 0;
+        }
+
+        std::size_t refcount() const { return owner().mRefs; }
+
+        // shares the storage of "source", the reference held on a
+        // previously shared storage is released first
+        void share(Segment& source) {
+            Segment& o = source.owner();
+            if (&o == &owner()) {
+                return;
+            }
+            if (mOwner) {
+                release();
+            }
+            mOwner = &o;
+            retain();
+        }
+
+        unsigned char* data = nullptr;
+        std::size_t length = 0;
+
+    private:
+        Segment* mOwner = nullptr;
+        std::size_t mRefs = 1;
+    };
+
+    // zero-copy chain of buffer segments (mbuf / pbuf style)
+    // the chain never copies nor owns the bytes, to_iovec() hands the
+    // segments to writev / sendmsg as they are
+    class BufferChain {
+
+    public:
+
+        using iterator = List<Segment>::iterator;
+        using const_iterator = List<Segment>::const_iterator;
+        using size_type = std::size_t;
+
+        BufferChain() = default;
+
+        BufferChain(const BufferChain& other) = delete;
+        BufferChain& operator=(const BufferChain& other) = delete;
+
+        iterator begin() { return mSegments.begin(); }
+        iterator end() { return mSegments.end(); }
+
+        const_iterator begin() const { return mSegments.begin(); }
+        const_iterator end() const { return mSegments.end(); }
+
+        bool empty() const { return mSegments.empty(); }
+
+        // number of segments
+        size_type segments() const { return mSegments.size(); }
+
+        // number of bytes
+        size_type length() const;
+
+        void append(Segment& s) { mSegments.push_back(s); }
+        void prepend(Segment& s) { mSegments.push_front(s); }
+
+        // moves every segment of "other" to the end of this chain
+        void concat(BufferChain& other) { mSegments.splice(mSegments.end(), other.mSegments); }
+
+        // moves the segments from "pos" to the end in front of "tail"
+        void split(iterator pos, BufferChain& tail);
+
+        // moves the bytes from "offset" to the end in front of "tail", a
+        // segment straddling "offset" is cut in two and its second half is
+        // described by "spare", returns true when "spare" was used
+        bool split(size_type offset, BufferChain& tail, Segment& spare);
+
+        // fills up to "count" iovec-like entries (iov_base / iov_len),
+        // returns the number of entries written
+        template<typename iovec_t>
+        size_type to_iovec(iovec_t* iov, size_type count) const;
+
+        // copies up to "size" bytes, for the paths that need flat memory
+        size_type copy_to(void* dst, size_type size) const;
+
+        void clear() { mSegments.clear(); }
+
+    private:
+
+        List<Segment> mSegments;
+
+    };
+
+    inline BufferChain::size_type BufferChain::length() const {
+        size_type total = 0;
+        for (auto it = begin(); it != end(); ++it) {
+            total += it->length;
+        }
+        return total;
+    }
+
+    inline void BufferChain::split(iterator pos, BufferChain& tail) {
+        tail.mSegments.splice(tail.begin(), mSegments, pos, end());
+    }
+
+    inline bool BufferChain::split(size_type offset, BufferChain& tail, Segment& spare) {
+
+        size_type start = 0;
+
+        for (auto it = begin(); it != end(); ++it) {
+
+            Segment& s = *it;
+
+            if (offset == start) {
+                split(it, tail);
+                return false;
+            }
+
+            if (offset < start + s.length) {
+                const size_type head = offset - start;
+                spare.data = s.data + head;
+                spare.length = s.length - head;
+                spare.share(s);
+                s.length = head;
+                mSegments.insert_after(it, spare);
+                split(iterator(&spare), tail);
+                return true;
+            }
+
+            start += s.length;
+        }
+
+        return false;
+    }
+
+    template<typename iovec_t>
+    BufferChain::size_type BufferChain::to_iovec(iovec_t* iov, size_type count) const {
+        size_type i = 0;
+        for (auto it = begin(); it != end() && i < count; ++it) {
+            iov[i].iov_base = it->data;
+            iov[i].iov_len = it->length;
+            i++;
+        }
+        return i;
+    }
+
+    inline BufferChain::size_type BufferChain::copy_to(void* dst, size_type size) const {
+        auto* out = static_cast<unsigned char*>(dst);
+        size_type copied = 0;
+        for (auto it = begin(); it != end() && copied < size; ++it) {
+            const size_type chunk = (it->length < size - copied) ? it->length : size - copied;
+            if (chunk) {
+                std::memcpy(out + copied, it->data, chunk);
+            }
+            copied += chunk;
+        }
+        return copied;
+    }
+
+}
@@ -0,0 +1,275 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "ulink_coro.hpp requires C++20 coroutines"
+#endif
+
+#include "ulink.hpp"
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace ulink {
+
+    // coroutine primitives whose awaiters are nodes stored in the frame of
+    // the suspended coroutine : suspending links the awaiter into the
+    // primitive's waiter list, resuming unlinks it, nothing is allocated
+    // and a frame destroyed while suspended simply leaves the list
+    //
+    // waiters are resumed inline, in FIFO order, by the call that releases
+    // them, the primitives are not thread safe
+
+    // manual-reset event
+    class AsyncEvent {
+
+    public:
+
+        struct Awaiter : Node<Awaiter> {
+            explicit Awaiter(AsyncEvent& e) : mEvent(e) {}
+            bool await_ready() const noexcept { return mEvent.mSet; }
+            void await_suspend(std::coroutine_handle<> h) noexcept { mHandle = h; mEvent.mWaiters.push_back(*this); }
+            void await_resume() const noexcept {}
+        private:
+            friend class AsyncEvent;
+            AsyncEvent& mEvent;
+            std::coroutine_handle<> mHandle;
+        };
+
+        AsyncEvent(bool set = false) : mSet(set) {}
+
+        AsyncEvent(const AsyncEvent& other) = delete;
+        AsyncEvent& operator=(const AsyncEvent& other) = delete;
+
+        Awaiter operator co_await() noexcept { return Awaiter(*this); }
+
+        // sets the event and resumes every waiter
+        void set();
+
+        void reset() { mSet = false; }
+
+        bool is_set() const { return mSet; }
+
+        bool has_waiters() const { return !mWaiters.empty(); }
+
+    private:
+        List<Awaiter> mWaiters;
+        bool mSet;
+    };
+
+    // channel of T values, capacity 0 being a rendezvous where a sender
+    // waits for a receiver and conversely
+    // senders keep their value in their awaiter until it is taken
+    template<typename T, std::size_t capacity = 0>
+    class Channel {
+
+    public:
+
+        using value_type = T;
+
+        struct SendAwaiter : Node<SendAwaiter> {
+            SendAwaiter(Channel& ch, T value) : mChannel(ch), mValue(std::move(value)) {}
+            bool await_ready() { return mChannel.trySend(*this); }
+            void await_suspend(std::coroutine_handle<> h) noexcept { mHandle = h; mChannel.mSenders.push_back(*this); }
+            // false if the channel was closed before the value was taken
+            bool await_resume() const noexcept { return mSent; }
+        private:
+            friend class Channel;
+            Channel& mChannel;
+            T mValue;
+            std::coroutine_handle<> mHandle;
+            bool mSent = false;
+        };
+
+        struct ReceiveAwaiter : Node<ReceiveAwaiter> {
+            explicit ReceiveAwaiter(Channel& ch) : mChannel(ch) {}
+            bool await_ready() { return mChannel.tryReceive(*this); }
+            void await_suspend(std::coroutine_handle<> h) noexcept { mHandle = h; mChannel.mReceivers.push_back(*this); }
+            // empty once the channel is closed and drained
+            std::optional<T> await_resume() { return std::move(mValue); }
+        private:
+            friend class Channel;
+            Channel& mChannel;
+            std::optional<T> mValue;
+            std::coroutine_handle<> mHandle;
+        };
+
+        Channel() = default;
+
+        Channel(const Channel& other) = delete;
+        Channel& operator=(const Channel& other) = delete;
+
+        // co_await ch.send(v) -> bool
+        SendAwaiter send(T value) { return SendAwaiter(*this, std::move(value)); }
+
+        // co_await ch.receive() -> std::optional<T>
+        ReceiveAwaiter receive() { return ReceiveAwaiter(*this); }
+
+        // resumes every waiter, senders fail and receivers get the
+        // buffered values then nothing
+        void close();
+
+        bool closed() const { return mClosed; }
+
+        std::size_t size() const { return mCount; }
+
+    private:
+
+        bool trySend(SendAwaiter& s);
+        bool tryReceive(ReceiveAwaiter& r);
+
+        void pushValue(T&& value);
+        T popValue();
+
+        List<SendAwaiter> mSenders;
+        List<ReceiveAwaiter> mReceivers;
+        std::array<std::optional<T>, capacity> mBuffer;
+        std::size_t mHead = 0;
+        std::size_t mCount = 0;
+        bool mClosed = false;
+
+    };
+
+    inline void AsyncEvent::set() {
+
+        mSet = true;
+
+        // detached first : a resumed coroutine may wait again, or destroy
+        // another waiting frame which then leaves "pending" on its own
+        List<Awaiter> pending;
+        pending.splice(pending.end(), mWaiters);
+
+        while (!pending.empty()) {
+            Awaiter& a = pending.front();
+            a.remove();
+            a.mHandle.resume();
+        }
+    }
+
+    template<typename T, std::size_t capacity>
+    void Channel<T, capacity>::close() {
+
+        mClosed = true;
+
+        List<ReceiveAwaiter> receivers;
+        receivers.splice(receivers.end(), mReceivers);
+
+        List<SendAwaiter> senders;
+        senders.splice(senders.end(), mSenders);
+
+        while (!receivers.empty()) {
+            ReceiveAwaiter& r = receivers.front();
+            r.remove();
+            r.mHandle.resume();
+        }
+
+        while (!senders.empty()) {
+            SendAwaiter& s = senders.front();
+            s.remove();
+            s.mHandle.resume();
+        }
+    }
+
+    template<typename T, std::size_t capacity>
+    bool Channel<T, capacity>::trySend(SendAwaiter& s) {
+
+        if (mClosed) {
+            return true;
+        }
+
+        if (!mReceivers.empty()) {
+            // the buffer is empty when receivers wait
+            ReceiveAwaiter& r = mReceivers.front();
+            r.remove();
+            r.mValue.emplace(std::move(s.mValue));
+            s.mSent = true;
+            r.mHandle.resume();
+            return true;
+        }
+
+        if constexpr (capacity > 0) {
+            if (mCount < capacity) {
+                pushValue(std::move(s.mValue));
+                s.mSent = true;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    template<typename T, std::size_t capacity>
+    bool Channel<T, capacity>::tryReceive(ReceiveAwaiter& r) {
+
+        if constexpr (capacity > 0) {
+            if (mCount) {
+                r.mValue.emplace(popValue());
+                // a slot was freed for the oldest blocked sender
+                if (!mSenders.empty()) {
+                    SendAwaiter& s = mSenders.front();
+                    s.remove();
+                    pushValue(std::move(s.mValue));
+                    s.mSent = true;
+                    s.mHandle.resume();
+                }
+                return true;
+            }
+        }
+
+        if (!mSenders.empty()) {
+            SendAwaiter& s = mSenders.front();
+            s.remove();
+            r.mValue.emplace(std::move(s.mValue));
+            s.mSent = true;
+            s.mHandle.resume();
+            return true;
+        }
+
+        return mClosed;
+    }
+
+    template<typename T, std::size_t capacity>
+    void Channel<T, capacity>::pushValue(T&& value) {
+        mBuffer[(mHead + mCount) % capacity].emplace(std::move(value));
+        mCount++;
+    }
+
+    template<typename T, std::size_t capacity>
+    T Channel<T, capacity>::popValue() {
+        T value = std::move(*mBuffer[mHead]);
+        mBuffer[mHead].reset();
+        mHead = (mHead + 1) % capacity;
+        mCount--;
+        return value;
+    }
+
+}
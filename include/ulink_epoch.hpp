@@ -0,0 +1,262 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+
+namespace ulink {
+
+    // epoch based reclamation for nodes that concurrent readers reach
+    // through links other than their ulink::Node hook (e.g. atomic links)
+    //
+    // each thread owns a Participant : readers pin() it around a traversal,
+    // writers retire() the nodes they unlinked, the node's Node<T> hook
+    // chaining it into one of the participant's three per-epoch retire lists
+    // the global epoch moves on once every pinned participant has seen it,
+    // and a list retired at epoch "e" is reclaimed as a batch from "e + 2",
+    // when no reader can still hold its nodes
+    //
+    // nothing is allocated : participants take one of "max_threads" records
+    // of the domain, pin() is one store and a fence
+    template<typename T, std::size_t max_threads = 64>
+    class EpochDomain {
+
+        static_assert(
+            std::is_convertible_v<T*, Node<T>*>,
+            "Node type error"
+            );
+
+        static_assert(max_threads > 0, "at least one record is needed");
+
+        // 0 when idle, (epoch << 1) | 1 when pinned
+        struct alignas(64) Record {
+            std::atomic<std::uint64_t> mState { 0 };
+            std::atomic<bool> mClaimed { false };
+        };
+
+    public:
+
+        using reclaim_t = void(*)(T&);
+
+        class Participant;
+
+        // "reclaim" is called on every node once it is safe, from the thread
+        // of the participant that retired it, "batch" retirements trigger a
+        // collection
+        explicit EpochDomain(reclaim_t reclaim, std::size_t batch = 64) :
+            mReclaim(reclaim),
+            mBatch(batch) {}
+
+        EpochDomain(const EpochDomain& other) = delete;
+        EpochDomain& operator=(const EpochDomain& other) = delete;
+
+        std::uint64_t epoch() const { return mEpoch.load(); }
+
+        // moves the epoch on if every pinned participant has seen it
+        bool try_advance();
+
+    private:
+
+        reclaim_t mReclaim;
+        std::size_t mBatch;
+
+        alignas(64) std::atomic<std::uint64_t> mEpoch { 0 };
+        Record mRecords[max_threads];
+
+    };
+
+    // per-thread handle, its methods are to be called by its own thread only
+    template<typename T, std::size_t max_threads>
+    class EpochDomain<T, max_threads>::Participant {
+
+        struct Bucket {
+            List<T> mNodes;
+            std::uint64_t mEpoch = 0;
+        };
+
+    public:
+
+        // pins for the scope of the guard
+        class Guard {
+        public:
+            explicit Guard(Participant& p) : mParticipant(p) { p.pin(); }
+            ~Guard() { mParticipant.unpin(); }
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+        private:
+            Participant& mParticipant;
+        };
+
+        // waits for a free record when all are taken
+        explicit Participant(EpochDomain& domain);
+
+        Participant(const Participant& other) = delete;
+        Participant& operator=(const Participant& other) = delete;
+
+        // reclaims everything it retired, waiting for the readers to advance
+        // a thread is meant to own a single participant per domain : while
+        // the same thread keeps another participant of the domain pinned,
+        // the epoch cannot move on and this destructor never returns
+        ~Participant();
+
+        // the fence keeps the loads of the traversal from being ordered
+        // before the pin, it pairs with the one of try_advance()
+        void pin() {
+            mRecord->mState.store((mDomain.mEpoch.load() << 1) | 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        void unpin() { mRecord->mState.store(0, std::memory_order_release); }
+
+        // "node" must already be unreachable for readers that pin afterwards
+        // and not linked in any List, its hook is reused until reclaim
+        void retire(T& node);
+
+        // tries to advance the epoch and reclaims the safe lists, returns the
+        // number of nodes reclaimed
+        std::size_t collect();
+
+        // retired nodes not reclaimed yet
+        std::size_t pending() const { return mPending; }
+
+    private:
+
+        std::size_t reclaim(Bucket& b);
+
+        EpochDomain& mDomain;
+        Record* mRecord = nullptr;
+        Bucket mBuckets[3];
+        std::size_t mPending = 0;
+
+    };
+
+    template<typename T, std::size_t max_threads>
+    bool EpochDomain<T, max_threads>::try_advance() {
+
+        // orders the unlinks of the caller before the records are read
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        std::uint64_t e = mEpoch.load();
+
+        for (const auto& r : mRecords) {
+            const std::uint64_t state = r.mState.load();
+            if ((state & 1) && (state >> 1) != e) {
+                return false;
+            }
+        }
+
+        // fails only if another thread advanced it already
+        mEpoch.compare_exchange_strong(e, e + 1);
+        return true;
+    }
+
+    template<typename T, std::size_t max_threads>
+    EpochDomain<T, max_threads>::Participant::Participant(EpochDomain& domain) : mDomain(domain) {
+        for (;;) {
+            for (auto& r : domain.mRecords) {
+                bool expected = false;
+                if (!r.mClaimed.load(std::memory_order_relaxed) &&
+                    r.mClaimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    mRecord = &r;
+                    return;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    template<typename T, std::size_t max_threads>
+    EpochDomain<T, max_threads>::Participant::~Participant() {
+
+        unpin();
+
+        while (collect(), mPending) {
+            std::this_thread::yield();
+        }
+
+        mRecord->mClaimed.store(false, std::memory_order_release);
+    }
+
+    template<typename T, std::size_t max_threads>
+    void EpochDomain<T, max_threads>::Participant::retire(T& node) {
+
+        const std::uint64_t e = mDomain.mEpoch.load();
+        Bucket& b = mBuckets[e % 3];
+
+        // the bucket held epoch "e - 3" or older, safe since "e - 1"
+        if (b.mEpoch != e) {
+            reclaim(b);
+            b.mEpoch = e;
+        }
+
+        b.mNodes.push_back(node);
+
+        if (++mPending >= mDomain.mBatch) {
+            collect();
+        }
+    }
+
+    template<typename T, std::size_t max_threads>
+    std::size_t EpochDomain<T, max_threads>::Participant::collect() {
+
+        mDomain.try_advance();
+
+        const std::uint64_t e = mDomain.mEpoch.load();
+        std::size_t count = 0;
+
+        for (auto& b : mBuckets) {
+            if (b.mEpoch + 2 <= e) {
+                count += reclaim(b);
+            }
+        }
+
+        return count;
+    }
+
+    template<typename T, std::size_t max_threads>
+    std::size_t EpochDomain<T, max_threads>::Participant::reclaim(Bucket& b) {
+
+        std::size_t count = 0;
+
+        while (!b.mNodes.empty()) {
+            T& node = b.mNodes.front();
+            b.mNodes.pop_front();
+            mDomain.mReclaim(node);
+            count++;
+        }
+
+        mPending -= count;
+        return count;
+    }
+
+}
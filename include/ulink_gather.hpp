@@ -0,0 +1,126 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <cstddef>
+#include <functional>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ULINK_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define ULINK_PREFETCH(addr) ((void)(addr))
+#endif
+
+namespace ulink {
+
+    // one array of a structure-of-arrays snapshot : "data[i]" mirrors
+    // projection(i-th node), the projection being a pointer to member or
+    // any callable returning a reference to the node field
+    template<typename value_t, typename projection_t>
+    struct Column {
+        value_t* data;
+        projection_t projection;
+    };
+
+    template<typename value_t, typename projection_t>
+    Column<value_t, projection_t> column(value_t* data, projection_t projection) {
+        return { data, projection };
+    }
+
+    // copies the projected fields of the first "capacity" nodes into the
+    // columns in a single walk, returns the number of nodes copied
+    template<typename node_t, typename... columns_t>
+    std::size_t gather(const List<node_t>& list, std::size_t capacity, columns_t... columns);
+
+    template<typename node_t, typename value_t, typename projection_t>
+    std::size_t gather(const List<node_t>& list, value_t* out, std::size_t capacity, projection_t projection) {
+        return gather(list, capacity, column(out, projection));
+    }
+
+    // writes the columns back into the first "count" nodes, returns the
+    // number of nodes written
+    template<typename node_t, typename... columns_t>
+    std::size_t scatter(List<node_t>& list, std::size_t count, columns_t... columns);
+
+    template<typename node_t, typename value_t, typename projection_t>
+    std::size_t scatter(List<node_t>& list, const value_t* in, std::size_t count, projection_t projection) {
+        return scatter(list, count, column(in, projection));
+    }
+
+    template<typename node_t, typename... columns_t>
+    std::size_t gather(const List<node_t>& list, std::size_t capacity, columns_t... columns) {
+
+        std::size_t i = 0;
+        auto it = list.begin();
+
+        while (i < capacity && it != list.end()) {
+
+            // start loading the next node while this one is copied
+            auto next = it;
+            ++next;
+            if (next != list.end()) {
+                ULINK_PREFETCH(&(*next));
+            }
+
+            const node_t& node = *it;
+            ((columns.data[i] = std::invoke(columns.projection, node)), ...);
+
+            it = next;
+            i++;
+        }
+
+        return i;
+    }
+
+    template<typename node_t, typename... columns_t>
+    std::size_t scatter(List<node_t>& list, std::size_t count, columns_t... columns) {
+
+        std::size_t i = 0;
+        auto it = list.begin();
+
+        while (i < count && it != list.end()) {
+
+            auto next = it;
+            ++next;
+            if (next != list.end()) {
+                ULINK_PREFETCH(&(*next));
+            }
+
+            node_t& node = *it;
+            ((std::invoke(columns.projection, node) = columns.data[i]), ...);
+
+            it = next;
+            i++;
+        }
+
+        return i;
+    }
+
+}
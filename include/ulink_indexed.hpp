@@ -0,0 +1,444 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace ulink {
+
+    // forward declaration
+    template<typename T, std::size_t levels = 8>
+    struct IndexedNode;
+
+    template<typename node_t>
+    class IndexedList;
+
+    // non-owning doubly linked list with O(log n) positional access
+    // level 0 is a plain ulink::List, the upper levels form an indexable
+    // skip list whose links store the number of positions they span
+    template<typename node_t>
+    class IndexedList {
+
+        using hook_t = IndexedNode<node_t, node_t::index_levels>;
+
+        static_assert(
+            std::is_convertible_v<node_t*, hook_t*>,
+            "Node type error"
+            );
+
+        static constexpr std::size_t kTowerSize = node_t::index_levels - 1;
+
+    public:
+
+        using iterator = typename List<node_t>::iterator;
+        using const_iterator = typename List<node_t>::const_iterator;
+        using reverse_iterator = typename List<node_t>::reverse_iterator;
+        using const_reverse_iterator = typename List<node_t>::const_reverse_iterator;
+        using value_type = node_t;
+        using size_type = std::size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        IndexedList();
+
+        IndexedList(const IndexedList& other) = delete;
+        IndexedList& operator=(const IndexedList& other) = delete;
+
+        iterator begin() { return mList.begin(); }
+        iterator end() { return mList.end(); }
+
+        const_iterator begin() const { return mList.begin(); }
+        const_iterator end() const { return mList.end(); }
+
+        reverse_iterator rbegin() { return mList.rbegin(); }
+        reverse_iterator rend() { return mList.rend(); }
+
+        const_reverse_iterator rbegin() const { return mList.rbegin(); }
+        const_reverse_iterator rend() const { return mList.rend(); }
+
+        reference front() { return mList.front(); }
+        reference back() { return mList.back(); }
+
+        const_reference front() const { return mList.front(); }
+        const_reference back() const { return mList.back(); }
+
+        // O(log n)
+        size_type size() const;
+        bool empty() const { return mList.empty(); }
+        void clear();
+
+        void push_front(reference node) { insert_before(begin(), node); }
+        void push_back(reference node) { insert_before(end(), node); }
+
+        void pop_front();
+        void pop_back();
+
+        iterator insert_before(iterator pos, reference node);
+        iterator insert_after(iterator pos, reference node);
+
+        // returns the iterator following the erased node
+        iterator erase(iterator pos);
+
+        // iterator to the k-th node (0 based) or end(), O(log n)
+        iterator nth(size_type k);
+        const_iterator nth(size_type k) const;
+
+        // position of a linked node (0 based), O(log n)
+        size_type index_of(const_reference node) const;
+
+        ~IndexedList() { clear(); }
+
+    private:
+
+        // for each upper level, the last node before "node" on that level
+        // and its distance to "node"
+        void predecessors(hook_t& node, hook_t** update, size_type* distance);
+
+        std::size_t randomHeight();
+
+        List<node_t> mList;
+        hook_t mHead;
+        std::uint32_t mSeed = 0x9E3779B9u;
+
+    };
+
+    template<typename node_t>
+    IndexedList<node_t>::IndexedList() {
+        // the head is on every level, which stops all upward walks
+        mHead.mHeight = static_cast<unsigned char>(kTowerSize);
+    }
+
+    template<typename node_t>
+    typename IndexedList<node_t>::size_type IndexedList<node_t>::size() const {
+        return empty() ? 0 : index_of(back()) + 1;
+    }
+
+    template<typename node_t>
+    void IndexedList<node_t>::clear() {
+
+        // level 0 is unlinked through Node<T>::remove : the towers being
+        // gone, IndexedNode::remove would search each node's predecessor
+        for (auto& n : mList.stable()) {
+            hook_t& hook = n;
+            for (std::size_t l = 0; l < hook.mHeight; l++) {
+                hook.mPrev[l] = hook.mNext[l] = nullptr;
+                hook.mWidth[l] = 0;
+            }
+            hook.mHeight = 0;
+            static_cast<Node<node_t>&>(hook).remove();
+        }
+
+        for (std::size_t l = 0; l < kTowerSize; l++) {
+            mHead.mNext[l] = nullptr;
+            mHead.mWidth[l] = 0;
+        }
+    }
+
+    template<typename node_t>
+    void IndexedList<node_t>::pop_front() {
+        if (empty()) {
+            return;
+        }
+        static_cast<hook_t&>(mList.front()).remove();
+    }
+
+    template<typename node_t>
+    void IndexedList<node_t>::pop_back() {
+        if (empty()) {
+            return;
+        }
+        static_cast<hook_t&>(mList.back()).remove();
+    }
+
+    template<typename node_t>
+    typename IndexedList<node_t>::iterator IndexedList<node_t>::insert_before(iterator pos, reference node) {
+
+        // the position must not be the node being (re)inserted
+        if (&(*pos) == &node) {
+            ++pos;
+        }
+
+        hook_t& hook = node;
+        hook.remove();
+
+        mList.insert_before(pos, node);
+
+        hook_t* update[kTowerSize];
+        size_type distance[kTowerSize];
+        predecessors(hook, update, distance);
+
+        const std::size_t height = randomHeight();
+
+        for (std::size_t l = 0; l < kTowerSize; l++) {
+
+            auto* p = update[l];
+            auto* n = p->mNext[l];
+
+            if (l < height) {
+                hook.mPrev[l] = p;
+                hook.mNext[l] = n;
+                if (n) {
+                    n->mPrev[l] = &hook;
+                    hook.mWidth[l] = p->mWidth[l] + 1 - distance[l];
+                }
+                p->mNext[l] = &hook;
+                p->mWidth[l] = distance[l];
+            }
+            else if (n) {
+                // the link now spans the new node
+                p->mWidth[l]++;
+            }
+        }
+
+        hook.mHeight = static_cast<unsigned char>(height);
+
+        return iterator(&node);
+    }
+
+    template<typename node_t>
+    typename IndexedList<node_t>::iterator IndexedList<node_t>::insert_after(iterator pos, reference node) {
+        if (pos != end()) {
+            ++pos;
+        }
+        return insert_before(pos, node);
+    }
+
+    template<typename node_t>
+    typename IndexedList<node_t>::iterator IndexedList<node_t>::erase(iterator pos) {
+        if (pos == end()) {
+            return pos;
+        }
+        auto next = pos;
+        ++next;
+        static_cast<hook_t&>(*pos).remove();
+        return next;
+    }
+
+    template<typename node_t>
+    typename IndexedList<node_t>::iterator IndexedList<node_t>::nth(size_type k) {
+
+        // positions are 1 based, the head being at 0
+        const size_type target = k + 1;
+        size_type p = 0;
+        hook_t* x = &mHead;
+
+        for (std::size_t l = kTowerSize; l-- > 0;) {
+            while (x->mNext[l] && p + x->mWidth[l] <= target) {
+                p += x->mWidth[l];
+                x = x->mNext[l];
+            }
+        }
+
+        iterator it = begin();
+
+        if (x == &mHead) {
+            p = 1;
+        }
+        else {
+            it = iterator(static_cast<node_t*>(x));
+        }
+
+        while (p < target && it != end()) {
+            ++it;
+            ++p;
+        }
+
+        return it;
+    }
+
+    template<typename node_t>
+    typename IndexedList<node_t>::const_iterator IndexedList<node_t>::nth(size_type k) const {
+        auto it = const_cast<IndexedList*>(this)->nth(k);
+        return const_iterator(&(*it));
+    }
+
+    template<typename node_t>
+    typename IndexedList<node_t>::size_type IndexedList<node_t>::index_of(const_reference node) const {
+        hook_t* update[kTowerSize];
+        size_type distance[kTowerSize];
+        const_cast<IndexedList*>(this)->predecessors(
+            const_cast<reference>(node),
+            update,
+            distance
+        );
+
+        // walk the top level back to the head
+        constexpr std::size_t top = kTowerSize - 1;
+        auto* y = update[top];
+        size_type d = distance[top];
+
+        while (y != &mHead) {
+            y = y->mPrev[top];
+            d += y->mWidth[top];
+        }
+
+        return d - 1;
+    }
+
+    template<typename node_t>
+    void IndexedList<node_t>::predecessors(hook_t& node, hook_t** update, size_type* distance) {
+
+        // nearest node before "node" that has a tower, or the head
+        hook_t* y = &mHead;
+        size_type d = 0;
+
+        for (auto it = iterator(static_cast<node_t*>(&node)); it != begin();) {
+            --it;
+            d++;
+            hook_t& h = *it;
+            if (h.mHeight) {
+                y = &h;
+                break;
+            }
+        }
+
+        if (y == &mHead) {
+            d++;
+        }
+
+        // climb : a node's predecessor on its top level is the nearest
+        // node that is at least as high
+        for (std::size_t l = 0; l < kTowerSize; l++) {
+            while (y->mHeight <= l) {
+                const std::size_t top = y->mHeight - 1u;
+                auto* p = y->mPrev[top];
+                d += p->mWidth[top];
+                y = p;
+            }
+            update[l] = y;
+            distance[l] = d;
+        }
+    }
+
+    template<typename node_t>
+    std::size_t IndexedList<node_t>::randomHeight() {
+
+        // xorshift32, each extra level has a probability of 1/4
+        mSeed ^= mSeed << 13;
+        mSeed ^= mSeed >> 17;
+        mSeed ^= mSeed << 5;
+
+        auto r = mSeed;
+        std::size_t height = 0;
+
+        while (height < kTowerSize && (r & 3) == 0) {
+            height++;
+            r >>= 2;
+        }
+
+        return height;
+    }
+
+
+
+
+    // hook for IndexedList, a Node<T> extended with a tower of "levels - 1"
+    // doubly linked upper levels, each link storing the positions it spans
+    // nth and index_of stay O(log n) while the list is below 4^levels nodes
+    template<typename T, std::size_t levels>
+    struct IndexedNode : Node<T> {
+
+        static_assert(levels >= 2 && levels <= 16, "invalid level count");
+
+        static constexpr std::size_t index_levels = levels;
+
+        void remove();
+
+        ~IndexedNode() { remove(); }
+
+    protected:
+
+        template<typename node_t>
+        friend class IndexedList;
+
+        IndexedNode* mPrev[levels - 1] = {};
+        IndexedNode* mNext[levels - 1] = {};
+        std::size_t mWidth[levels - 1] = {};
+        unsigned char mHeight = 0;
+    };
+
+    template<typename T, std::size_t levels>
+    void IndexedNode<T, levels>::remove() {
+
+        if (!this->isLinked()) {
+            return;
+        }
+
+        // nearest following node that has a tower, used below to find
+        // the links of the upper levels that jump over this node
+        IndexedNode* y = nullptr;
+
+        if (mHeight) {
+            y = mNext[mHeight - 1];
+        }
+        else {
+            // the list end sentinel is the only node without a "next"
+            for (Node<T>* n = this->next; Node<T>::successor(*n); n = Node<T>::successor(*n)) {
+                IndexedNode* h = static_cast<T*>(n);
+                if (h->mHeight) {
+                    y = h;
+                    break;
+                }
+            }
+        }
+
+        for (std::size_t l = mHeight; l < levels - 1; l++) {
+            while (y && y->mHeight <= l) {
+                y = y->mNext[y->mHeight - 1];
+            }
+            if (!y) {
+                break;
+            }
+            y->mPrev[l]->mWidth[l]--;
+        }
+
+        for (std::size_t l = 0; l < mHeight; l++) {
+            auto* p = mPrev[l];
+            auto* n = mNext[l];
+            p->mNext[l] = n;
+            if (n) {
+                n->mPrev[l] = p;
+                p->mWidth[l] += mWidth[l] - 1;
+            }
+            else {
+                p->mWidth[l] = 0;
+            }
+            mPrev[l] = mNext[l] = nullptr;
+            mWidth[l] = 0;
+        }
+
+        mHeight = 0;
+
+        Node<T>::remove();
+    }
+
+}
@@ -0,0 +1,225 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace ulink {
+
+    // calls fn(node) for every node of the list from several threads,
+    // the calling thread being one of them
+    // the list is cut into segments by a single pre-pass, each thread owns
+    // a contiguous block of segments and steals from the other blocks once
+    // its own is done
+    // the list must not be modified until the call returns
+    template<typename node_t, typename function_t>
+    void parallel_for_each(
+        List<node_t>& list,
+        function_t fn,
+        std::size_t threads = std::thread::hardware_concurrency()
+    );
+
+    // stable sort on several threads : the list is halved by relinking
+    // until every thread owns a segment, each segment is sorted with
+    // List::sort and the sorted runs are merged back pairwise as the
+    // threads join, the only allocations being the std::thread ones
+    template<typename node_t, typename compare_t>
+    void parallel_sort(
+        List<node_t>& list,
+        compare_t comp,
+        std::size_t threads = std::thread::hardware_concurrency()
+    );
+
+    namespace detail {
+
+        // segments per thread, more segments balance better but cost
+        // more claims
+        constexpr std::size_t kSegmentsPerThread = 8;
+
+        struct alignas(64) SegmentBlock {
+            std::atomic<std::size_t> next { 0 };
+            std::size_t last = 0;
+        };
+
+        // cuts [it, end) into at most "2 * segments" segments of "stride"
+        // nodes (the last one may be shorter) in a single walk : whenever
+        // there are too many boundaries, every other one is dropped and the
+        // stride doubles
+        template<typename iterator_t>
+        std::vector<iterator_t> splitSegments(
+            iterator_t it,
+            iterator_t end,
+            std::size_t segments
+        ) {
+            std::vector<iterator_t> bounds;
+            bounds.reserve(2 * segments + 1);
+
+            std::size_t stride = 1;
+
+            for (std::size_t count = 0; it != end; ++it, ++count) {
+
+                if (count % stride) {
+                    continue;
+                }
+
+                if (bounds.size() == 2 * segments) {
+                    for (std::size_t i = 0; i < segments; i++) {
+                        bounds[i] = bounds[2 * i];
+                    }
+                    bounds.erase(bounds.begin() + segments, bounds.end());
+                    stride *= 2;
+                    if (count % stride) {
+                        continue;
+                    }
+                }
+
+                bounds.push_back(it);
+            }
+
+            bounds.push_back(end);
+
+            return bounds;
+        }
+
+        // below this size, a segment is not worth a thread
+        constexpr std::size_t kMinParallelSortSize = 4096;
+
+        template<typename node_t, typename compare_t>
+        void parallelSort(List<node_t>& list, std::size_t count, const compare_t& comp, std::size_t threads) {
+
+            if (threads <= 1 || count < kMinParallelSortSize) {
+                list.sort(comp);
+                return;
+            }
+
+            // move the upper half into a list owned by this frame
+            const std::size_t lowerCount = count / 2;
+            const std::size_t lowerThreads = threads / 2;
+
+            auto mid = list.begin();
+            for (std::size_t i = 0; i < lowerCount; i++) {
+                ++mid;
+            }
+
+            List<node_t> upper;
+            upper.splice(upper.end(), list, mid, list.end());
+
+            std::thread helper([&upper, &comp, count, lowerCount, threads, lowerThreads] {
+                parallelSort(upper, count - lowerCount, comp, threads - lowerThreads);
+            });
+
+            parallelSort(list, lowerCount, comp, lowerThreads);
+
+            helper.join();
+
+            list.merge(upper, comp);
+        }
+
+        // runs job(segment) for every segment index, each exactly once
+        template<typename job_t>
+        void runSegments(std::size_t segments, std::size_t threads, job_t& job) {
+
+            std::vector<SegmentBlock> blocks(threads);
+
+            for (std::size_t t = 0; t < threads; t++) {
+                blocks[t].next = t * segments / threads;
+                blocks[t].last = (t + 1) * segments / threads;
+            }
+
+            auto worker = [&blocks, &job, threads] (std::size_t self) {
+                // own block first, then steal from the following ones
+                for (std::size_t v = 0; v < threads; v++) {
+                    auto& block = blocks[(self + v) % threads];
+                    for (;;) {
+                        const std::size_t s = block.next.fetch_add(1, std::memory_order_relaxed);
+                        if (s >= block.last) {
+                            break;
+                        }
+                        job(s);
+                    }
+                }
+            };
+
+            std::vector<std::thread> pool;
+            pool.reserve(threads - 1);
+
+            for (std::size_t t = 1; t < threads; t++) {
+                pool.emplace_back(worker, t);
+            }
+
+            worker(0);
+
+            for (auto& th : pool) {
+                th.join();
+            }
+        }
+
+    }
+
+    template<typename node_t, typename function_t>
+    void parallel_for_each(List<node_t>& list, function_t fn, std::size_t threads) {
+
+        threads = std::max<std::size_t>(threads, 1);
+
+        if (threads <= 1) {
+            for (auto& n : list) {
+                fn(n);
+            }
+            return;
+        }
+
+        const auto bounds = detail::splitSegments(list.begin(), list.end(), threads * detail::kSegmentsPerThread);
+        const std::size_t segments = bounds.size() - 1;
+
+        if (segments == 0) {
+            return;
+        }
+
+        threads = std::min(threads, segments);
+
+        auto job = [&bounds, &fn] (std::size_t s) {
+            for (auto it = bounds[s]; it != bounds[s + 1]; ++it) {
+                fn(*it);
+            }
+        };
+
+        detail::runSegments(segments, threads, job);
+    }
+
+    template<typename node_t, typename compare_t>
+    void parallel_sort(List<node_t>& list, compare_t comp, std::size_t threads) {
+        detail::parallelSort(list, list.size(), comp, std::max<std::size_t>(threads, 1));
+    }
+
+}
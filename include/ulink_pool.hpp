@@ -0,0 +1,242 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <cstddef>
+
+namespace ulink {
+
+    // default lock of ObjectPool : single-threaded use
+    struct NoLock {
+        void lock() {}
+        void unlock() {}
+    };
+
+    // fixed pool of N objects stored inside the pool itself
+    // free objects are chained through their own Node<T> hook, which is
+    // available to the user again once the object is acquired
+    // lock_t may be any type with lock() / unlock(), e.g. std::mutex
+    template<typename T, std::size_t N, typename lock_t = NoLock>
+    class ObjectPool {
+
+        static_assert(
+            std::is_convertible_v<T*, Node<T>*>,
+            "Node type error"
+            );
+
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using list_type = List<T>;
+
+        ObjectPool();
+
+        ObjectPool(const ObjectPool& other) = delete;
+        ObjectPool& operator=(const ObjectPool& other) = delete;
+
+        // nullptr when the pool is exhausted
+        T* acquire();
+
+        // the object is removed from any list it is linked in
+        void release(T& obj);
+
+        // moves up to "count" free objects to "out", returns the number moved
+        size_type acquire(list_type& out, size_type count);
+
+        // gives every object of "in" back to the pool
+        void release(list_type& in);
+
+        size_type available() const;
+
+        static constexpr size_type capacity() { return N; }
+
+        bool owns(const T& obj) const;
+
+    private:
+
+        struct Guard {
+            Guard(lock_t& l) : mLock(l) { mLock.lock(); }
+            ~Guard() { mLock.unlock(); }
+            lock_t& mLock;
+        };
+
+        T mObjects[N];
+        list_type mFree;
+        mutable lock_t mLock;
+
+    };
+
+    template<typename T, std::size_t N, typename lock_t>
+    ObjectPool<T, N, lock_t>::ObjectPool() {
+        for (auto& obj : mObjects) {
+            mFree.push_back(obj);
+        }
+    }
+
+    template<typename T, std::size_t N, typename lock_t>
+    T* ObjectPool<T, N, lock_t>::acquire() {
+        Guard guard(mLock);
+        if (mFree.empty()) {
+            return nullptr;
+        }
+        auto* obj = &mFree.front();
+        mFree.pop_front();
+        return obj;
+    }
+
+    template<typename T, std::size_t N, typename lock_t>
+    void ObjectPool<T, N, lock_t>::release(T& obj) {
+        Guard guard(mLock);
+        mFree.push_front(obj);
+    }
+
+    template<typename T, std::size_t N, typename lock_t>
+    typename ObjectPool<T, N, lock_t>::size_type ObjectPool<T, N, lock_t>::acquire(list_type& out, size_type count) {
+
+        Guard guard(mLock);
+
+        auto last = mFree.begin();
+        size_type moved = 0;
+
+        while (moved < count && last != mFree.end()) {
+            ++last;
+            moved++;
+        }
+
+        out.splice(out.end(), mFree, mFree.begin(), last);
+
+        return moved;
+    }
+
+    template<typename T, std::size_t N, typename lock_t>
+    void ObjectPool<T, N, lock_t>::release(list_type& in) {
+        Guard guard(mLock);
+        mFree.splice(mFree.begin(), in);
+    }
+
+    template<typename T, std::size_t N, typename lock_t>
+    typename ObjectPool<T, N, lock_t>::size_type ObjectPool<T, N, lock_t>::available() const {
+        Guard guard(mLock);
+        return mFree.size();
+    }
+
+    template<typename T, std::size_t N, typename lock_t>
+    bool ObjectPool<T, N, lock_t>::owns(const T& obj) const {
+        return (&obj >= mObjects && &obj < mObjects + N);
+    }
+
+
+
+
+    // per-thread front end of a shared ObjectPool : objects are taken from
+    // and given back to the pool "batch" at a time, so the pool lock is
+    // taken once per batch instead of once per object
+    template<typename pool_t, std::size_t batch = 16>
+    class PoolCache {
+
+        static_assert(batch > 0, "batch must not be empty");
+
+    public:
+
+        using value_type = typename pool_t::value_type;
+        using size_type = std::size_t;
+
+        PoolCache(pool_t& pool) : mPool(pool) {}
+
+        PoolCache(const PoolCache& other) = delete;
+        PoolCache& operator=(const PoolCache& other) = delete;
+
+        // nullptr when both the cache and the pool are exhausted
+        value_type* acquire();
+
+        void release(value_type& obj);
+
+        size_type cached() const { return mCount; }
+
+        ~PoolCache() { mPool.release(mCache); }
+
+    private:
+
+        pool_t& mPool;
+        typename pool_t::list_type mCache;
+        size_type mCount = 0;
+
+    };
+
+    template<typename pool_t, std::size_t batch>
+    typename PoolCache<pool_t, batch>::value_type* PoolCache<pool_t, batch>::acquire() {
+
+        if (mCache.empty()) {
+            mCount = mPool.acquire(mCache, batch);
+            if (mCount == 0) {
+                return nullptr;
+            }
+        }
+
+        auto* obj = &mCache.front();
+        mCache.pop_front();
+        mCount--;
+        return obj;
+    }
+
+    template<typename pool_t, std::size_t batch>
+    void PoolCache<pool_t, batch>::release(value_type& obj) {
+
+        // a second release of a cached object is ignored, the walk is
+        // bounded by 2 * batch and only taken for linked objects
+        if (obj.isLinked()) {
+            for (auto& cached : mCache) {
+                if (&cached == &obj) {
+                    return;
+                }
+            }
+        }
+
+        mCache.push_front(obj);
+        mCount++;
+
+        if (mCount < 2 * batch) {
+            return;
+        }
+
+        // keep one batch, give the other one back
+        auto first = mCache.begin();
+        for (size_type i = 0; i < batch; i++) {
+            ++first;
+        }
+
+        typename pool_t::list_type surplus;
+        surplus.splice(surplus.end(), mCache, first, mCache.end());
+        mPool.release(surplus);
+        mCount = batch;
+    }
+
+}
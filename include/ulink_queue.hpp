@@ -0,0 +1,373 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+
+namespace ulink {
+
+    // forward declaration
+    template<typename node_t, std::size_t hazard_slots>
+    class MpmcQueue;
+
+    template<typename node_t>
+    class MpscQueue;
+
+    // hook of the concurrent queues, its link is atomic so it is distinct
+    // from ulink::Node : an object may carry both and sit in a List once
+    // it has been popped
+    template<typename T>
+    struct QueueNode {
+
+    protected:
+
+        template<typename node_t, std::size_t hazard_slots>
+        friend class MpmcQueue;
+
+        template<typename node_t>
+        friend class MpscQueue;
+
+        std::atomic<QueueNode*> mQueueNext { nullptr };
+    };
+
+    // multi-producer multi-consumer FIFO (Michael-Scott) of QueueNode
+    // hooks, nodes being linked in place so push and pop never allocate
+    //
+    // a queue owned stub node keeps the queue non-empty, it is skipped by
+    // pop() and pushed again behind the last node when that one is popped
+    // operations protect the node they read through one of "hazard_slots"
+    // hazard pointers, claimed per operation (no thread registration)
+    // pop() returns a node only once no other thread holds it as a hazard,
+    // so it may be pushed again or destroyed right away without ABA
+    //
+    // progress : the links are updated with CAS and no mutex, but the queue
+    // is not lock-free, it blocks in two places
+    // - pop() yields until every hazard on the node it unlinked is gone, a
+    //   thread preempted while protecting that node stalls the popper
+    // - more concurrent threads than "hazard_slots" yield for a free slot,
+    //   so size it to the number of threads using the queue
+    template<typename node_t, std::size_t hazard_slots = 16>
+    class MpmcQueue {
+
+        using hook_t = QueueNode<node_t>;
+
+        static_assert(
+            std::is_convertible_v<node_t*, hook_t*>,
+            "Node type error"
+            );
+
+        static_assert(hazard_slots > 0, "at least one hazard slot is needed");
+
+        // one cache line per slot, they are written by different threads
+        struct alignas(64) Slot {
+            std::atomic<hook_t*> mHazard { nullptr };
+        };
+
+        // claims a slot for the duration of an operation
+        class Hazard {
+        public:
+            explicit Hazard(MpmcQueue& q);
+            ~Hazard() { mSlot->mHazard.store(nullptr, std::memory_order_release); }
+            // reads "src" until the protected value is confirmed
+            hook_t* protect(const std::atomic<hook_t*>& src);
+        private:
+            Slot* mSlot;
+        };
+
+    public:
+
+        using value_type = node_t;
+        using reference = value_type&;
+
+        MpmcQueue();
+
+        MpmcQueue(const MpmcQueue& other) = delete;
+        MpmcQueue& operator=(const MpmcQueue& other) = delete;
+
+        void push(reference node);
+
+        // nullptr when empty
+        node_t* pop();
+
+        // snapshot, may be outdated by the time it returns
+        bool empty() const;
+
+    private:
+
+        void pushHook(hook_t& node);
+
+        // spins until no slot protects "node"
+        void waitUnprotected(const hook_t* node) const;
+
+        std::atomic<hook_t*> mHead;
+        Slot mSlots[hazard_slots];
+        std::atomic<hook_t*> mTail;
+        hook_t mStub;
+        std::atomic<bool> mStubQueued { true };
+
+        // value of claimed slots that protect nothing yet, never linked
+        hook_t mClaimed;
+
+    };
+
+    template<typename node_t, std::size_t hazard_slots>
+    MpmcQueue<node_t, hazard_slots>::Hazard::Hazard(MpmcQueue& q) {
+
+        // start from the slot this thread got last time
+        static thread_local std::size_t hint = 0;
+
+        for (std::size_t i = hint;; i++) {
+
+            Slot& s = q.mSlots[i % hazard_slots];
+            hook_t* expected = nullptr;
+
+            if (!s.mHazard.load(std::memory_order_relaxed) &&
+                s.mHazard.compare_exchange_strong(expected, &q.mClaimed)) {
+                mSlot = &s;
+                hint = i % hazard_slots;
+                return;
+            }
+
+            if ((i + 1) % hazard_slots == hint) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    template<typename node_t, std::size_t hazard_slots>
+    typename MpmcQueue<node_t, hazard_slots>::hook_t*
+        MpmcQueue<node_t, hazard_slots>::Hazard::protect(const std::atomic<hook_t*>& src) {
+        hook_t* p = src.load(std::memory_order_acquire);
+        for (;;) {
+            mSlot->mHazard.store(p);
+            hook_t* q = src.load();
+            if (q == p) {
+                return p;
+            }
+            p = q;
+        }
+    }
+
+    template<typename node_t, std::size_t hazard_slots>
+    MpmcQueue<node_t, hazard_slots>::MpmcQueue() :
+        mHead(&mStub),
+        mTail(&mStub) {}
+
+    template<typename node_t, std::size_t hazard_slots>
+    void MpmcQueue<node_t, hazard_slots>::push(reference node) {
+        pushHook(node);
+    }
+
+    template<typename node_t, std::size_t hazard_slots>
+    void MpmcQueue<node_t, hazard_slots>::pushHook(hook_t& node) {
+
+        node.mQueueNext.store(nullptr, std::memory_order_relaxed);
+
+        Hazard hazard(*this);
+
+        for (;;) {
+
+            hook_t* t = hazard.protect(mTail);
+            hook_t* next = t->mQueueNext.load(std::memory_order_acquire);
+
+            if (next) {
+                // lagging tail
+                mTail.compare_exchange_weak(t, next);
+                continue;
+            }
+
+            if (t->mQueueNext.compare_exchange_weak(next, &node, std::memory_order_release, std::memory_order_relaxed)) {
+                mTail.compare_exchange_strong(t, &node);
+                return;
+            }
+        }
+    }
+
+    template<typename node_t, std::size_t hazard_slots>
+    node_t* MpmcQueue<node_t, hazard_slots>::pop() {
+
+        for (;;) {
+
+            hook_t* h;
+            bool popped = false;
+            bool stubNeeded = false;
+            bool queueStub = false;
+
+            {
+                Hazard hazard(*this);
+
+                h = hazard.protect(mHead);
+                hook_t* next = h->mQueueNext.load(std::memory_order_acquire);
+
+                if (!next) {
+
+                    if (h == &mStub) {
+                        return nullptr;
+                    }
+
+                    // "h" is the last node and the tail : queue the stub
+                    // behind it, unless another thread is doing so
+                    bool expected = false;
+                    stubNeeded = true;
+                    queueStub = mStubQueued.compare_exchange_strong(expected, true);
+                }
+                else {
+                    hook_t* t = mTail.load();
+                    if (t == h) {
+                        mTail.compare_exchange_strong(t, next);
+                    }
+                    popped = mHead.compare_exchange_strong(h, next);
+                }
+            }
+
+            if (!popped) {
+                // pushed without holding a slot, so one slot is enough
+                if (queueStub) {
+                    pushHook(mStub);
+                }
+                else if (stubNeeded) {
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+
+            // "h" is ours, readers that protected it before the head moved
+            // are about to give up on it
+            waitUnprotected(h);
+
+            if (h == &mStub) {
+                mStubQueued.store(false, std::memory_order_release);
+                continue;
+            }
+
+            return static_cast<node_t*>(h);
+        }
+    }
+
+    template<typename node_t, std::size_t hazard_slots>
+    bool MpmcQueue<node_t, hazard_slots>::empty() const {
+        const hook_t* h = mHead.load(std::memory_order_acquire);
+        return (h == &mStub && !mStub.mQueueNext.load(std::memory_order_acquire));
+    }
+
+    template<typename node_t, std::size_t hazard_slots>
+    void MpmcQueue<node_t, hazard_slots>::waitUnprotected(const hook_t* node) const {
+        for (const auto& s : mSlots) {
+            while (s.mHazard.load() == node) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // multi-producer single-consumer FIFO of QueueNode hooks : push is one
+    // exchange and never waits, pop never waits either but may return
+    // nullptr while a push is half done
+    template<typename node_t>
+    class MpscQueue {
+
+        using hook_t = QueueNode<node_t>;
+
+        static_assert(
+            std::is_convertible_v<node_t*, hook_t*>,
+            "Node type error"
+            );
+
+    public:
+
+        using value_type = node_t;
+        using reference = value_type&;
+
+        MpscQueue() : mBack(&mStub), mFront(&mStub) {}
+
+        MpscQueue(const MpscQueue& other) = delete;
+        MpscQueue& operator=(const MpscQueue& other) = delete;
+
+        // any thread
+        void push(reference node) { pushHook(node); }
+
+        // consumer thread only, nullptr when empty
+        node_t* pop();
+
+    private:
+
+        void pushHook(hook_t& node);
+
+        std::atomic<hook_t*> mBack;
+        alignas(64) hook_t* mFront;
+        hook_t mStub;
+
+    };
+
+    template<typename node_t>
+    void MpscQueue<node_t>::pushHook(hook_t& node) {
+        node.mQueueNext.store(nullptr, std::memory_order_relaxed);
+        hook_t* prev = mBack.exchange(&node, std::memory_order_acq_rel);
+        prev->mQueueNext.store(&node, std::memory_order_release);
+    }
+
+    template<typename node_t>
+    node_t* MpscQueue<node_t>::pop() {
+
+        hook_t* front = mFront;
+        hook_t* next = front->mQueueNext.load(std::memory_order_acquire);
+
+        if (front == &mStub) {
+            if (!next) {
+                return nullptr;
+            }
+            mFront = next;
+            front = next;
+            next = next->mQueueNext.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            mFront = next;
+            return static_cast<node_t*>(front);
+        }
+
+        if (front != mBack.load(std::memory_order_acquire)) {
+            // a producer is between its exchange and its link
+            return nullptr;
+        }
+
+        // "front" is the last node : the stub takes its place
+        pushHook(mStub);
+
+        next = front->mQueueNext.load(std::memory_order_acquire);
+        if (next) {
+            mFront = next;
+            return static_cast<node_t*>(front);
+        }
+
+        return nullptr;
+    }
+
+}
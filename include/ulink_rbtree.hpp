@@ -0,0 +1,740 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include <cstddef>
+#include <csignal>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace ulink {
+
+    // forward declaration
+    template<typename T>
+    struct RbNode;
+
+    template<typename node_t, typename compare_t = std::less<node_t>>
+    class RbTree;
+
+    // non-owning red-black tree (ordered multiset)
+    template<typename node_t, typename compare_t>
+    class RbTree {
+
+        static_assert(
+            std::is_convertible_v<node_t*, RbNode<node_t>*>,
+            "Node type error"
+            );
+
+        using hook_t = RbNode<node_t>;
+
+        template<bool is_forward>
+        struct ConstIterator;
+
+        template<bool is_forward>
+        struct Iterator {
+            Iterator(hook_t* n) : mNode(n) {}
+            node_t& operator*() { return *static_cast<node_t*>(mNode); }
+            Iterator& operator++() { mNode = is_forward ? hook_t::next(mNode) : hook_t::prev(mNode); return *this; }
+            Iterator& operator--() { mNode = is_forward ? hook_t::prev(mNode) : hook_t::next(mNode); return *this; }
+            bool operator !=(const Iterator& it) const { return (mNode != it.mNode); }
+            bool operator ==(const Iterator& it) const { return (mNode == it.mNode); }
+            node_t* operator ->() { return static_cast<node_t*>(mNode); }
+            operator ConstIterator<is_forward>() const { return ConstIterator<is_forward>(mNode); }
+        private:
+            hook_t* mNode;
+        };
+
+        template<bool is_forward>
+        struct ConstIterator {
+            ConstIterator(const hook_t* n) : mNode(n) {}
+            const node_t& operator*() const { return *static_cast<const node_t*>(mNode); }
+            ConstIterator& operator++() { mNode = is_forward ? hook_t::next(mNode) : hook_t::prev(mNode); return *this; }
+            ConstIterator& operator--() { mNode = is_forward ? hook_t::prev(mNode) : hook_t::next(mNode); return *this; }
+            bool operator !=(const ConstIterator& it) const { return (mNode != it.mNode); }
+            bool operator ==(const ConstIterator& it) const { return (mNode == it.mNode); }
+            const node_t* operator ->() const { return static_cast<const node_t*>(mNode); }
+        private:
+            const hook_t* mNode;
+        };
+
+    public:
+
+        using iterator = Iterator<true>;
+        using const_iterator = ConstIterator<true>;
+        using reverse_iterator = Iterator<false>;
+        using const_reverse_iterator = ConstIterator<false>;
+        using value_type = node_t;
+        using size_type = std::size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using key_compare = compare_t;
+
+        RbTree(const compare_t& comp = compare_t());
+
+        RbTree(const RbTree& other) = delete;
+        RbTree& operator=(const RbTree& other) = delete;
+
+        iterator begin();
+        iterator end();
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        reverse_iterator rbegin();
+        reverse_iterator rend();
+
+        const_reverse_iterator rbegin() const;
+        const_reverse_iterator rend() const;
+
+        reference front();
+        reference back();
+
+        const_reference front() const;
+        const_reference back() const;
+
+        size_type size() const;
+        bool empty() const;
+        void clear();
+
+        // equivalent nodes are kept in insertion order
+        iterator insert(reference node);
+
+        // returns the iterator following the erased node
+        iterator erase(iterator pos);
+
+        // keys are compared with compare_t(node, key) and compare_t(key, node)
+        template<typename key_t>
+        iterator find(const key_t& key);
+
+        template<typename key_t>
+        const_iterator find(const key_t& key) const;
+
+        template<typename key_t>
+        iterator lower_bound(const key_t& key);
+
+        template<typename key_t>
+        const_iterator lower_bound(const key_t& key) const;
+
+        template<typename key_t>
+        iterator upper_bound(const key_t& key);
+
+        template<typename key_t>
+        const_iterator upper_bound(const key_t& key) const;
+
+        template<typename key_t>
+        std::pair<iterator, iterator> equal_range(const key_t& key);
+
+        template<typename key_t>
+        std::pair<const_iterator, const_iterator> equal_range(const key_t& key) const;
+
+        ~RbTree() { clear(); }
+
+    private:
+
+        template<typename key_t>
+        hook_t* lowerBound(const key_t& key) const;
+
+        template<typename key_t>
+        hook_t* upperBound(const key_t& key) const;
+
+        static const node_t& value(const hook_t* n) { return *static_cast<const node_t*>(n); }
+
+        hook_t mHeader;
+        compare_t mCompare;
+
+    };
+
+    template<typename node_t, typename compare_t>
+    RbTree<node_t, compare_t>::RbTree(const compare_t& comp) : mCompare(comp) {
+        mHeader.color = hook_t::Color::Header;
+    }
+
+    template<typename node_t, typename compare_t>
+    typename RbTree<node_t, compare_t>::iterator RbTree<node_t, compare_t>::begin() {
+        return iterator(empty() ? &mHeader : hook_t::minimum(mHeader.parent));
+    }
+
+    template<typename node_t, typename compare_t>
+    typename RbTree<node_t, compare_t>::iterator RbTree<node_t, compare_t>::end() {
+        return iterator(&mHeader);
+    }
+
+    template<typename node_t, typename compare_t>
+    typename RbTree<node_t, compare_t>::const_iterator RbTree<node_t, compare_t>::begin() const {
+        return const_iterator(empty() ? &mHeader : hook_t::minimum(mHeader.parent));
+    }
+
+    template<typename node_t, typename compare_t>
+    typename RbTree<node_t, compare_t>::const_iterator RbTree<node_t, compare_t>::end() const {
+        return const_iterator(&mHeader);
+    }
+
+    template<typename node_t, typename compare_t>
+    typename RbTree<node_t, compare_t>::reverse_iterator RbTree<node_t, compare_t>::rbegin() {
+        return reverse_iterator(empty() ? &mHeader : hook_t::maximum(mHeader.parent));
+    }
+
+    template<typename node_t, typename compare_t>
+    typename RbTree<node_t, compare_t>::reverse_iterator RbTree<node_t, compare_t>::rend() {
+        return reverse_iterator(&mHeader);
+    }
+
+    template<typename node_t, typename compare_t>
+    typename RbTree<node_t, compare_t>::const_reverse_iterator RbTree<node_t, compare_t>::rbegin() const {
+        return const_reverse_iterator(empty() ? &mHeader : hook_t::maximum(mHeader.parent));
+    }
+
+    template<typename node_t, typename compare_t>
+    typename RbTree<node_t, compare_t>::const_reverse_iterator RbTree<node_t, compare_t>::rend() const {
+        return const_reverse_iterator(&mHeader);
+    }
+
+    template<typename node_t, typename compare_t>
+    node_t& RbTree<node_t, compare_t>::front() {
+        if (empty()) {
+            std::raise(SIGSEGV);
+        }
+        return *begin();
+    }
+
+    template<typename node_t, typename compare_t>
+    node_t& RbTree<node_t, compare_t>::back() {
+        if (empty()) {
+            std::raise(SIGSEGV);
+        }
+        return *rbegin();
+    }
+
+    template<typename node_t, typename compare_t>
+    const node_t& RbTree<node_t, compare_t>::front() const {
+        if (empty()) {
+            std::raise(SIGSEGV);
+        }
+        return *begin();
+    }
+
+    template<typename node_t, typename compare_t>
+    const node_t& RbTree<node_t, compare_t>::back() const {
+        if (empty()) {
+            std::raise(SIGSEGV);
+        }
+        return *rbegin();
+    }
+
+    template<typename node_t, typename compare_t>
+    typename RbTree<node_t, compare_t>::size_type RbTree<node_t, compare_t>::size() const {
+        size_type outSize = 0;
+        for (auto it = begin(); it != end(); ++it) {
+            outSize++;
+        }
+        return outSize;
+    }
+
+    template<typename node_t, typename compare_t>
+    bool RbTree<node_t, compare_t>::empty() const {
+        return (mHeader.parent == nullptr);
+    }
+
+    template<typename node_t, typename compare_t>
+    void RbTree<node_t, compare_t>::clear() {
+
+        // post-order walk, unhooking every leaf from its parent
+        auto* n = mHeader.parent;
+
+        while (n) {
+
+            if (n->left) {
+                n = n->left;
+                continue;
+            }
+
+            if (n->right) {
+                n = n->right;
+                continue;
+            }
+
+            auto* p = n->parent;
+            hook_t::replaceChild(p, n, nullptr);
+            n->parent = nullptr;
+            n->color = hook_t::Color::Red;
+            n = (p == &mHeader) ? nullptr : p;
+        }
+    }
+
+    template<typename node_t, typename compare_t>
+    typename RbTree<node_t, compare_t>::iterator RbTree<node_t, compare_t>::insert(reference node) {
+
+        hook_t& hook = node;
+        hook.remove();
+
+        hook_t* parent = &mHeader;
+        hook_t* n = mHeader.parent;
+        bool goLeft = true;
+
+        while (n) {
+            parent = n;
+            goLeft = mCompare(node, value(n));
+            n = goLeft ? n->left : n->right;
+        }
+
+        hook.parent = parent;
+        hook.color = hook_t::Color::Red;
+
+        if (parent == &mHeader) {
+            mHeader.parent = &hook;
+        }
+        else if (goLeft) {
+            parent->left = &hook;
+        }
+        else {
+            parent->right = &hook;
+        }
+
+        hook_t::insertFixup(&hook, &mHeader);
+
+        return iterator(&hook);
+    }
+
+    template<typename node_t, typename compare_t>
+    typename RbTree<node_t, compare_t>::iterator RbTree<node_t, compare_t>::erase(iterator pos) {
+        if (pos == end()) {
+            return pos;
+        }
+        auto next = pos;
+        ++next;
+        static_cast<hook_t&>(*pos).remove();
+        return next;
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    typename RbTree<node_t, compare_t>::iterator RbTree<node_t, compare_t>::find(const key_t& key) {
+        auto* n = lowerBound(key);
+        if (n == &mHeader || mCompare(key, value(n))) {
+            return end();
+        }
+        return iterator(n);
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    typename RbTree<node_t, compare_t>::const_iterator RbTree<node_t, compare_t>::find(const key_t& key) const {
+        auto* n = lowerBound(key);
+        if (n == &mHeader || mCompare(key, value(n))) {
+            return end();
+        }
+        return const_iterator(n);
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    typename RbTree<node_t, compare_t>::iterator RbTree<node_t, compare_t>::lower_bound(const key_t& key) {
+        return iterator(lowerBound(key));
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    typename RbTree<node_t, compare_t>::const_iterator RbTree<node_t, compare_t>::lower_bound(const key_t& key) const {
+        return const_iterator(lowerBound(key));
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    typename RbTree<node_t, compare_t>::iterator RbTree<node_t, compare_t>::upper_bound(const key_t& key) {
+        return iterator(upperBound(key));
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    typename RbTree<node_t, compare_t>::const_iterator RbTree<node_t, compare_t>::upper_bound(const key_t& key) const {
+        return const_iterator(upperBound(key));
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    std::pair<typename RbTree<node_t, compare_t>::iterator, typename RbTree<node_t, compare_t>::iterator>
+        RbTree<node_t, compare_t>::equal_range(const key_t& key) {
+        return { lower_bound(key), upper_bound(key) };
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    std::pair<typename RbTree<node_t, compare_t>::const_iterator, typename RbTree<node_t, compare_t>::const_iterator>
+        RbTree<node_t, compare_t>::equal_range(const key_t& key) const {
+        return { lower_bound(key), upper_bound(key) };
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    typename RbTree<node_t, compare_t>::hook_t* RbTree<node_t, compare_t>::lowerBound(const key_t& key) const {
+        // first node not less than key
+        auto* result = const_cast<hook_t*>(&mHeader);
+        auto* n = mHeader.parent;
+        while (n) {
+            if (mCompare(value(n), key)) {
+                n = n->right;
+            }
+            else {
+                result = n;
+                n = n->left;
+            }
+        }
+        return result;
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    typename RbTree<node_t, compare_t>::hook_t* RbTree<node_t, compare_t>::upperBound(const key_t& key) const {
+        // first node greater than key
+        auto* result = const_cast<hook_t*>(&mHeader);
+        auto* n = mHeader.parent;
+        while (n) {
+            if (mCompare(key, value(n))) {
+                result = n;
+                n = n->left;
+            }
+            else {
+                n = n->right;
+            }
+        }
+        return result;
+    }
+
+
+
+
+    template<typename T>
+    struct RbNode {
+
+        void remove();
+
+        bool isLinked() const;
+
+        ~RbNode() { remove(); }
+
+    protected:
+
+        template<typename node_t, typename compare_t>
+        friend class RbTree;
+
+        // the tree header is tagged so that a node can find its tree
+        // by walking up, which keeps the hook at three pointers
+        enum class Color : unsigned char { Red, Black, Header };
+
+        static RbNode* minimum(RbNode* n);
+        static RbNode* maximum(RbNode* n);
+        static RbNode* next(RbNode* n);
+        static RbNode* prev(RbNode* n);
+        static const RbNode* next(const RbNode* n) { return next(const_cast<RbNode*>(n)); }
+        static const RbNode* prev(const RbNode* n) { return prev(const_cast<RbNode*>(n)); }
+
+        static bool isRed(const RbNode* n) { return n && n->color == Color::Red; }
+        static void replaceChild(RbNode* p, RbNode* oldChild, RbNode* newChild);
+        static void rotateLeft(RbNode* x);
+        static void rotateRight(RbNode* x);
+        static void insertFixup(RbNode* z, RbNode* header);
+        static void eraseFixup(RbNode* x, RbNode* xParent, RbNode* header);
+
+        RbNode* parent = nullptr;
+        RbNode* left = nullptr;
+        RbNode* right = nullptr;
+        Color color = Color::Red;
+    };
+
+    template<typename T>
+    void RbNode<T>::remove() {
+
+        if (!parent || color == Color::Header) {
+            return;
+        }
+
+        auto* header = parent;
+        while (header->color != Color::Header) {
+            header = header->parent;
+        }
+
+        auto* z = this;
+        auto* y = z;
+        RbNode* x;
+        RbNode* xParent;
+        Color yColor = y->color;
+
+        if (!z->left) {
+            x = z->right;
+            xParent = z->parent;
+            replaceChild(z->parent, z, x);
+            if (x) x->parent = z->parent;
+        }
+        else if (!z->right) {
+            x = z->left;
+            xParent = z->parent;
+            replaceChild(z->parent, z, x);
+            x->parent = z->parent;
+        }
+        else {
+            // replace z by its successor y
+            y = minimum(z->right);
+            yColor = y->color;
+            x = y->right;
+
+            if (y->parent == z) {
+                xParent = y;
+            }
+            else {
+                xParent = y->parent;
+                replaceChild(y->parent, y, x);
+                if (x) x->parent = y->parent;
+                y->right = z->right;
+                y->right->parent = y;
+            }
+
+            replaceChild(z->parent, z, y);
+            y->parent = z->parent;
+            y->left = z->left;
+            y->left->parent = y;
+            y->color = z->color;
+        }
+
+        if (yColor == Color::Black) {
+            eraseFixup(x, xParent, header);
+        }
+
+        parent = left = right = nullptr;
+        color = Color::Red;
+    }
+
+    template<typename T>
+    bool RbNode<T>::isLinked() const {
+        return (parent != nullptr && color != Color::Header);
+    }
+
+    template<typename T>
+    RbNode<T>* RbNode<T>::minimum(RbNode* n) {
+        while (n->left) {
+            n = n->left;
+        }
+        return n;
+    }
+
+    template<typename T>
+    RbNode<T>* RbNode<T>::maximum(RbNode* n) {
+        while (n->right) {
+            n = n->right;
+        }
+        return n;
+    }
+
+    template<typename T>
+    RbNode<T>* RbNode<T>::next(RbNode* n) {
+        if (n->right) {
+            return minimum(n->right);
+        }
+        auto* p = n->parent;
+        while (p->color != Color::Header && n == p->right) {
+            n = p;
+            p = p->parent;
+        }
+        return p;
+    }
+
+    template<typename T>
+    RbNode<T>* RbNode<T>::prev(RbNode* n) {
+        if (n->color == Color::Header) {
+            // end() - 1
+            return maximum(n->parent);
+        }
+        if (n->left) {
+            return maximum(n->left);
+        }
+        auto* p = n->parent;
+        while (p->color != Color::Header && n == p->left) {
+            n = p;
+            p = p->parent;
+        }
+        return p;
+    }
+
+    template<typename T>
+    void RbNode<T>::replaceChild(RbNode* p, RbNode* oldChild, RbNode* newChild) {
+        if (p->color == Color::Header) {
+            p->parent = newChild;
+        }
+        else if (p->left == oldChild) {
+            p->left = newChild;
+        }
+        else {
+            p->right = newChild;
+        }
+    }
+
+    template<typename T>
+    void RbNode<T>::rotateLeft(RbNode* x) {
+        auto* y = x->right;
+        x->right = y->left;
+        if (y->left) {
+            y->left->parent = x;
+        }
+        y->parent = x->parent;
+        replaceChild(x->parent, x, y);
+        y->left = x;
+        x->parent = y;
+    }
+
+    template<typename T>
+    void RbNode<T>::rotateRight(RbNode* x) {
+        auto* y = x->left;
+        x->left = y->right;
+        if (y->right) {
+            y->right->parent = x;
+        }
+        y->parent = x->parent;
+        replaceChild(x->parent, x, y);
+        y->right = x;
+        x->parent = y;
+    }
+
+    template<typename T>
+    void RbNode<T>::insertFixup(RbNode* z, RbNode* header) {
+
+        // the header is never red, so the loop stops below the root
+        while (isRed(z->parent)) {
+
+            auto* p = z->parent;
+            auto* g = p->parent;
+
+            if (p == g->left) {
+                auto* u = g->right;
+                if (isRed(u)) {
+                    p->color = Color::Black;
+                    u->color = Color::Black;
+                    g->color = Color::Red;
+                    z = g;
+                }
+                else {
+                    if (z == p->right) {
+                        z = p;
+                        rotateLeft(z);
+                        p = z->parent;
+                    }
+                    p->color = Color::Black;
+                    g->color = Color::Red;
+                    rotateRight(g);
+                }
+            }
+            else {
+                auto* u = g->left;
+                if (isRed(u)) {
+                    p->color = Color::Black;
+                    u->color = Color::Black;
+                    g->color = Color::Red;
+                    z = g;
+                }
+                else {
+                    if (z == p->left) {
+                        z = p;
+                        rotateRight(z);
+                        p = z->parent;
+                    }
+                    p->color = Color::Black;
+                    g->color = Color::Red;
+                    rotateLeft(g);
+                }
+            }
+        }
+
+        header->parent->color = Color::Black;
+    }
+
+    template<typename T>
+    void RbNode<T>::eraseFixup(RbNode* x, RbNode* xParent, RbNode* header) {
+
+        while (x != header->parent && !isRed(x)) {
+
+            if (x == xParent->left) {
+                auto* w = xParent->right;
+                if (isRed(w)) {
+                    w->color = Color::Black;
+                    xParent->color = Color::Red;
+                    rotateLeft(xParent);
+                    w = xParent->right;
+                }
+                if (!isRed(w->left) && !isRed(w->right)) {
+                    w->color = Color::Red;
+                    x = xParent;
+                    xParent = x->parent;
+                }
+                else {
+                    if (!isRed(w->right)) {
+                        w->left->color = Color::Black;
+                        w->color = Color::Red;
+                        rotateRight(w);
+                        w = xParent->right;
+                    }
+                    w->color = xParent->color;
+                    xParent->color = Color::Black;
+                    w->right->color = Color::Black;
+                    rotateLeft(xParent);
+                    x = header->parent;
+                }
+            }
+            else {
+                auto* w = xParent->left;
+                if (isRed(w)) {
+                    w->color = Color::Black;
+                    xParent->color = Color::Red;
+                    rotateRight(xParent);
+                    w = xParent->left;
+                }
+                if (!isRed(w->left) && !isRed(w->right)) {
+                    w->color = Color::Red;
+                    x = xParent;
+                    xParent = x->parent;
+                }
+                else {
+                    if (!isRed(w->left)) {
+                        w->right->color = Color::Black;
+                        w->color = Color::Red;
+                        rotateLeft(w);
+                        w = xParent->left;
+                    }
+                    w->color = xParent->color;
+                    xParent->color = Color::Black;
+                    w->left->color = Color::Black;
+                    rotateRight(xParent);
+                    x = header->parent;
+                }
+            }
+        }
+
+        if (x) {
+            x->color = Color::Black;
+        }
+    }
+
+}
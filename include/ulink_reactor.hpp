@@ -0,0 +1,325 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#if !defined(__linux__)
+#error "ulink_reactor.hpp is built on Linux epoll"
+#endif
+
+#include "ulink.hpp"
+#include "ulink_skiplist.hpp"
+
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace ulink {
+
+    // single-threaded epoll event loop
+    // registered handlers are nodes of the reactor : each epoll_wait batch
+    // first moves the signaled handlers to the ready list, then dispatches
+    // it, so a handler removed or destroyed by another callback of the same
+    // batch simply leaves the list and is never called
+    // timers are kept in a skip list ordered by deadline
+    class Reactor {
+
+    public:
+
+        using clock = std::chrono::steady_clock;
+
+        // the callback receives the handler itself, a derived handler casts
+        // it back to reach its own state
+        class Handler : public Node<Handler> {
+
+        public:
+
+            using callback_t = void (*)(Handler& handler, std::uint32_t events);
+
+            Handler(int fd, callback_t callback) : mCallback(callback), mFd(fd) {}
+
+            Handler(const Handler& other) = delete;
+            Handler& operator=(const Handler& other) = delete;
+
+            ~Handler() { if (mReactor) mReactor->remove(*this); }
+
+            int fd() const { return mFd; }
+
+            // registered epoll events
+            std::uint32_t events() const { return mEvents; }
+
+            bool registered() const { return mReactor != nullptr; }
+
+        private:
+            friend class Reactor;
+            Reactor* mReactor = nullptr;
+            callback_t mCallback;
+            int mFd;
+            std::uint32_t mEvents = 0;
+            std::uint32_t mReadyEvents = 0;
+        };
+
+        class Timer : public SkipNode<Timer> {
+
+        public:
+
+            using callback_t = void (*)(Timer& timer);
+
+            explicit Timer(callback_t callback) : mCallback(callback) {}
+
+            Timer(const Timer& other) = delete;
+            Timer& operator=(const Timer& other) = delete;
+
+            clock::time_point deadline() const { return mDeadline; }
+
+            bool pending() const { return this->isLinked(); }
+
+            // removing the node cancels the timer
+            void cancel() { this->remove(); }
+
+        private:
+            friend class Reactor;
+            callback_t mCallback;
+            clock::time_point mDeadline {};
+        };
+
+        static constexpr int kBatchSize = 64;
+
+        Reactor();
+
+        Reactor(const Reactor& other) = delete;
+        Reactor& operator=(const Reactor& other) = delete;
+
+        // false if the epoll instance could not be created
+        bool valid() const { return mEpoll >= 0; }
+
+        // registers "h" for "events" (EPOLLIN, EPOLLOUT, ...), false and
+        // errno set on failure
+        bool add(Handler& h, std::uint32_t events);
+
+        bool modify(Handler& h, std::uint32_t events);
+
+        // unregisters "h", also done by its destructor
+        void remove(Handler& h);
+
+        // arms "t" for "deadline", rearming a pending timer moves it
+        void schedule(Timer& t, clock::time_point deadline);
+
+        void schedule_after(Timer& t, clock::duration delay) { schedule(t, clock::now() + delay); }
+
+        // waits for one batch of events, at most "timeout" or until the
+        // next deadline, then runs the due timers and the ready handlers
+        // returns the number of callbacks called
+        std::size_t run_once(std::chrono::milliseconds timeout = std::chrono::milliseconds(-1));
+
+        // runs batches until stop()
+        void run();
+
+        void stop() { mStopped = true; }
+
+        std::size_t handler_count() const { return mHandlers.size() + mReady.size(); }
+        std::size_t timer_count() const { return mTimers.size(); }
+
+        ~Reactor();
+
+    private:
+
+        struct ByDeadline {
+            bool operator()(const Timer& a, const Timer& b) const { return a.mDeadline < b.mDeadline; }
+        };
+
+        // epoll_wait timeout in milliseconds, rounded up to the next deadline
+        int waitTimeout(std::chrono::milliseconds timeout) const;
+
+        // negative waits forever, longer waits than epoll_wait takes are clamped
+        static int toTimeout(std::chrono::milliseconds ms);
+
+        std::size_t fireTimers();
+
+        int mEpoll;
+        List<Handler> mHandlers;
+        List<Handler> mReady;
+        SkipList<Timer, ByDeadline> mTimers;
+        epoll_event mEvents[kBatchSize];
+        bool mStopped = false;
+
+    };
+
+    inline Reactor::Reactor() : mEpoll(epoll_create1(EPOLL_CLOEXEC)) {}
+
+    inline Reactor::~Reactor() {
+        // handlers outliving the reactor must not call back into it
+        for (auto& h : mHandlers) h.mReactor = nullptr;
+        for (auto& h : mReady) h.mReactor = nullptr;
+        if (mEpoll >= 0) {
+            close(mEpoll);
+        }
+    }
+
+    inline bool Reactor::add(Handler& h, std::uint32_t events) {
+
+        if (h.mReactor) {
+            h.mReactor->remove(h);
+        }
+
+        epoll_event ev {};
+        ev.events = events;
+        ev.data.ptr = &h;
+
+        if (epoll_ctl(mEpoll, EPOLL_CTL_ADD, h.mFd, &ev) != 0) {
+            return false;
+        }
+
+        h.mReactor = this;
+        h.mEvents = events;
+        mHandlers.push_back(h);
+        return true;
+    }
+
+    inline bool Reactor::modify(Handler& h, std::uint32_t events) {
+
+        epoll_event ev {};
+        ev.events = events;
+        ev.data.ptr = &h;
+
+        if (epoll_ctl(mEpoll, EPOLL_CTL_MOD, h.mFd, &ev) != 0) {
+            return false;
+        }
+
+        h.mEvents = events;
+        return true;
+    }
+
+    inline void Reactor::remove(Handler& h) {
+        if (h.mReactor != this) {
+            return;
+        }
+        // the fd may already be closed, which unregistered it
+        epoll_ctl(mEpoll, EPOLL_CTL_DEL, h.mFd, nullptr);
+        h.mReactor = nullptr;
+        h.Node<Handler>::remove();
+    }
+
+    inline void Reactor::schedule(Timer& t, clock::time_point deadline) {
+        t.mDeadline = deadline;
+        mTimers.insert(t);
+    }
+
+    inline std::size_t Reactor::run_once(std::chrono::milliseconds timeout) {
+
+        const int n = epoll_wait(mEpoll, mEvents, kBatchSize, waitTimeout(timeout));
+
+        // every handler of the batch is queued before any callback runs
+        for (int i = 0; i < n; i++) {
+            auto* h = static_cast<Handler*>(mEvents[i].data.ptr);
+            h->mReadyEvents = mEvents[i].events;
+            mReady.push_back(*h);
+        }
+
+        std::size_t count = fireTimers();
+
+        while (!mReady.empty()) {
+            Handler& h = mReady.front();
+            mHandlers.push_back(h);
+            h.mCallback(h, h.mReadyEvents);
+            count++;
+        }
+
+        return count;
+    }
+
+    inline void Reactor::run() {
+        mStopped = false;
+        while (!mStopped) {
+            run_once();
+        }
+    }
+
+    inline int Reactor::waitTimeout(std::chrono::milliseconds timeout) const {
+
+        if (mTimers.empty()) {
+            return toTimeout(timeout);
+        }
+
+        const auto remaining = mTimers.front().mDeadline - clock::now();
+        if (remaining <= clock::duration::zero()) {
+            return 0;
+        }
+
+        // rounded up, waking before the deadline would only spin
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(remaining);
+        if (ms < remaining) {
+            ms += std::chrono::milliseconds(1);
+        }
+
+        if (timeout.count() >= 0 && timeout < ms) {
+            ms = timeout;
+        }
+
+        return toTimeout(ms);
+    }
+
+    inline int Reactor::toTimeout(std::chrono::milliseconds ms) {
+        if (ms.count() < 0) {
+            return -1;
+        }
+        if (ms.count() > INT_MAX) {
+            return INT_MAX;
+        }
+        return static_cast<int>(ms.count());
+    }
+
+    inline std::size_t Reactor::fireTimers() {
+
+        const auto now = clock::now();
+
+        // due timers are detached first, so that one rearmed by its own
+        // callback waits for the next batch
+        List<Timer> due;
+        while (!mTimers.empty() && !(now < mTimers.front().mDeadline)) {
+            Timer& t = mTimers.front();
+            mTimers.pop_front();
+            due.push_back(t);
+        }
+
+        std::size_t count = 0;
+
+        while (!due.empty()) {
+            Timer& t = due.front();
+            t.remove();
+            t.mCallback(t);
+            count++;
+        }
+
+        return count;
+    }
+
+}
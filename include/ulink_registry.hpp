@@ -0,0 +1,194 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+
+namespace ulink {
+
+    // forward declaration
+    template<typename T>
+    class Registry;
+
+    // hook of registry entries : a single forward link, entries being
+    // registered for the lifetime of the program they never unlink
+    template<typename T>
+    struct RegistryNode {
+
+    protected:
+
+        template<typename node_t>
+        friend class Registry;
+
+        T* mNextEntry = nullptr;
+    };
+
+    // self-registration list for objects with static storage duration
+    //
+    // the registry has a constexpr constructor and no destructor, so a
+    // namespace scope registry is constant-initialized (declare it constinit
+    // in C++20 to have it checked) and usable by the constructors of other
+    // globals whatever the dynamic initialization order
+    //
+    // add() is a lock-free push, safe from any thread and from constructors,
+    // walking the registry is safe concurrently with add()
+    // entries are walked most recent first unless sorted
+    template<typename T>
+    class Registry {
+
+        static_assert(
+            std::is_convertible_v<T*, RegistryNode<T>*>,
+            "Node type error"
+            );
+
+        template<typename value_t>
+        struct Iterator {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_t*;
+            using reference = value_t&;
+            Iterator() = default;
+            Iterator(value_t* n) : mNode(n) {}
+            value_t& operator*() const { return *mNode; }
+            value_t* operator ->() const { return mNode; }
+            Iterator& operator++() { mNode = hook(mNode)->mNextEntry; return *this; }
+            Iterator operator++(int) { Iterator it = *this; ++(*this); return it; }
+            bool operator !=(const Iterator& it) const { return (mNode != it.mNode); }
+            bool operator ==(const Iterator& it) const { return (mNode == it.mNode); }
+        private:
+            value_t* mNode = nullptr;
+        };
+
+    public:
+
+        using iterator = Iterator<T>;
+        using const_iterator = Iterator<const T>;
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = value_type&;
+
+        constexpr Registry() = default;
+
+        Registry(const Registry& other) = delete;
+        Registry& operator=(const Registry& other) = delete;
+
+        // lock-free push at the front
+        void add(reference entry);
+
+        iterator begin() { return iterator(mHead.load(std::memory_order_acquire)); }
+        iterator end() { return iterator(nullptr); }
+
+        const_iterator begin() const { return const_iterator(mHead.load(std::memory_order_acquire)); }
+        const_iterator end() const { return const_iterator(nullptr); }
+
+        // number of add() calls
+        size_type size() const { return mCount.load(std::memory_order_acquire); }
+        bool empty() const { return mHead.load(std::memory_order_acquire) == nullptr; }
+
+        // sorts the entries unless nothing was added since the last sort,
+        // meant for the first use, typically from main()
+        // it relinks the entries, so no other thread may walk the registry
+        // meanwhile, concurrent add() calls are fine : entries added during
+        // the sort end up behind the sorted ones and are sorted by the next
+        // call
+        template<typename compare_t>
+        Registry& sort_once(compare_t comp);
+
+    private:
+
+        static RegistryNode<T>* hook(T* n) { return n; }
+        static const RegistryNode<T>* hook(const T* n) { return n; }
+
+        std::atomic<T*> mHead { nullptr };
+        std::atomic<size_type> mCount { 0 };
+        std::atomic<size_type> mSortedCount { 0 };
+        std::atomic<bool> mSorting { false };
+
+    };
+
+    template<typename T>
+    void Registry<T>::add(reference entry) {
+        T* head = mHead.load(std::memory_order_relaxed);
+        do {
+            hook(&entry)->mNextEntry = head;
+        } while (!mHead.compare_exchange_weak(head, &entry, std::memory_order_release, std::memory_order_relaxed));
+        mCount.fetch_add(1, std::memory_order_release);
+    }
+
+    template<typename T>
+    template<typename compare_t>
+    Registry<T>& Registry<T>::sort_once(compare_t comp) {
+
+        if (mSortedCount.load(std::memory_order_acquire) == mCount.load(std::memory_order_acquire)) {
+            return *this;
+        }
+
+        // concurrent first uses wait for a single sorter
+        while (mSorting.exchange(true, std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        const size_type count = mCount.load(std::memory_order_acquire);
+
+        if (mSortedCount.load(std::memory_order_relaxed) != count) {
+
+            T* chain = detail::sortChain(
+                mHead.exchange(nullptr, std::memory_order_acquire),
+                [] (T* n) -> T*& { return hook(n)->mNextEntry; },
+                [&comp] (T* a, T* b) { return comp(*a, *b); }
+            );
+
+            if (chain) {
+                T* tail = chain;
+                while (hook(tail)->mNextEntry) {
+                    tail = hook(tail)->mNextEntry;
+                }
+
+                // entries added meanwhile are linked behind the sorted run
+                T* head = mHead.load(std::memory_order_relaxed);
+                do {
+                    hook(tail)->mNextEntry = head;
+                } while (!mHead.compare_exchange_weak(head, chain, std::memory_order_release, std::memory_order_relaxed));
+            }
+
+            mSortedCount.store(count, std::memory_order_release);
+        }
+
+        mSorting.store(false, std::memory_order_release);
+
+        return *this;
+    }
+
+}
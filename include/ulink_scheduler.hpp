@@ -0,0 +1,303 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace ulink {
+
+    // cooperative scheduler, tasks are nodes moving between the ready lists
+    // (one per priority, the highest non-empty one found through a bitmap),
+    // the sleep list ordered by wake-up time and caller-owned blocked lists
+    // nothing is allocated : the lists are made of the tasks themselves
+    //
+    // priorities range from 0 to priorities - 1, the highest runs first,
+    // tasks of the same priority run round robin
+    // clock_type only needs a static now() returning a time_point, so a tick
+    // counter can stand in for std::chrono::steady_clock
+    template<std::size_t priorities = 32, typename clock_type = std::chrono::steady_clock>
+    class Scheduler {
+
+        static_assert(priorities > 0 && priorities <= 32, "the ready bitmap is 32 bits wide");
+
+    public:
+
+        using time_point = typename clock_type::time_point;
+        using duration = typename clock_type::duration;
+        using size_type = std::size_t;
+
+        // a task is a step function called with the task itself rather than
+        // a virtual run(), so tasks carry no vtable and need no allocation
+        // priorities beyond priorities - 1 are clamped to it
+        class Task : public Node<Task> {
+
+        public:
+
+            enum class State : std::uint8_t { Idle, Ready, Running, Sleeping, Blocked };
+
+            using step_t = void (*)(Task& task);
+
+            explicit Task(step_t step, std::uint8_t priority = 0) : mStep(step), mPriority(clampPriority(priority)) {}
+
+            std::uint8_t priority() const { return mPriority; }
+
+            // the state is only meaningful while the task is linked, a
+            // task removed behind the scheduler's back is idle
+            State state() const { return this->isLinked() || mState == State::Running ? mState : State::Idle; }
+
+            time_point wake_time() const { return mWakeTime; }
+
+        private:
+            friend class Scheduler;
+            step_t mStep;
+            time_point mWakeTime {};
+            std::uint8_t mPriority;
+            State mState = State::Idle;
+        };
+
+        Scheduler() = default;
+
+        Scheduler(const Scheduler& other) = delete;
+        Scheduler& operator=(const Scheduler& other) = delete;
+
+        // appends "task" to the ready list of its priority, wherever it was
+        void ready(Task& task);
+
+        // changes the priority of "task", moving it if it is ready, clamped
+        // like the constructor's
+        void set_priority(Task& task, std::uint8_t priority);
+
+        // moves "task" to the sleep list until "when"
+        void sleep_until(Task& task, time_point when);
+        void sleep_for(Task& task, duration d);
+
+        // moves "task" to a caller-owned wait list, ready() or
+        // wake_one(waiters) makes it runnable again
+        void block(Task& task, List<Task>& waiters);
+
+        // readies the first task of "waiters", returns false if it is empty
+        bool wake_one(List<Task>& waiters);
+
+        // readies every task of "waiters"
+        size_type wake_all(List<Task>& waiters);
+
+        // unlinks "task", it no longer runs until readied again
+        void suspend(Task& task);
+
+        // readies the sleepers that are due, then runs one step of the
+        // highest priority ready task, returns false if none was ready
+        bool run_once();
+
+        // runs until stop(), idle(next) is called whenever nothing is ready,
+        // "next" being the earliest wake-up time or time_point::max()
+        template<typename idle_t>
+        void run(idle_t idle);
+
+        void stop() { mStopped = true; }
+
+        // earliest wake-up time, time_point::max() if nobody sleeps
+        time_point next_wake_time() const;
+
+        bool idle() const;
+
+        // number of task steps run so far
+        std::uint64_t switches() const { return mSwitches; }
+
+    private:
+
+        // moves the due sleepers to their ready list
+        void expire(time_point now);
+
+        Task* pickNext();
+
+        static unsigned highestBit(std::uint32_t x);
+
+        static constexpr std::uint8_t clampPriority(std::uint8_t priority) {
+            return (priority < priorities) ? priority : static_cast<std::uint8_t>(priorities - 1);
+        }
+
+        List<Task> mReady[priorities];
+        List<Task> mSleeping;
+        std::uint64_t mSwitches = 0;
+        std::uint32_t mReadyMap = 0;
+        bool mStopped = false;
+
+    };
+
+    template<std::size_t priorities, typename clock_type>
+    void Scheduler<priorities, clock_type>::ready(Task& task) {
+        const std::uint8_t prio = task.mPriority;
+        task.mState = Task::State::Ready;
+        mReady[prio].push_back(task);
+        mReadyMap |= std::uint32_t(1) << prio;
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    void Scheduler<priorities, clock_type>::set_priority(Task& task, std::uint8_t priority) {
+        const bool wasReady = task.state() == Task::State::Ready;
+        task.mPriority = clampPriority(priority);
+        if (wasReady) {
+            ready(task);
+        }
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    void Scheduler<priorities, clock_type>::sleep_until(Task& task, time_point when) {
+        task.mWakeTime = when;
+        task.mState = Task::State::Sleeping;
+        // wake-up times mostly grow, so the search from the back is short
+        mSleeping.insert_sorted(task, [] (const Task& a, const Task& b) {
+            return a.mWakeTime < b.mWakeTime;
+        });
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    void Scheduler<priorities, clock_type>::sleep_for(Task& task, duration d) {
+        sleep_until(task, clock_type::now() + d);
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    void Scheduler<priorities, clock_type>::block(Task& task, List<Task>& waiters) {
+        task.mState = Task::State::Blocked;
+        waiters.push_back(task);
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    bool Scheduler<priorities, clock_type>::wake_one(List<Task>& waiters) {
+        if (waiters.empty()) {
+            return false;
+        }
+        ready(waiters.front());
+        return true;
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    typename Scheduler<priorities, clock_type>::size_type Scheduler<priorities, clock_type>::wake_all(List<Task>& waiters) {
+        size_type count = 0;
+        while (wake_one(waiters)) {
+            count++;
+        }
+        return count;
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    void Scheduler<priorities, clock_type>::suspend(Task& task) {
+        task.remove();
+        task.mState = Task::State::Idle;
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    bool Scheduler<priorities, clock_type>::run_once() {
+
+        if (!mSleeping.empty()) {
+            expire(clock_type::now());
+        }
+
+        Task* task = pickNext();
+        if (!task) {
+            return false;
+        }
+
+        task->remove();
+        task->mState = Task::State::Running;
+        mSwitches++;
+
+        // the step runs again later unless it put the task to sleep,
+        // blocked or suspended it
+        task->mStep(*task);
+
+        // still running : back to the end of its ready list
+        if (task->mState == Task::State::Running && !task->isLinked()) {
+            ready(*task);
+        }
+
+        return true;
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    template<typename idle_t>
+    void Scheduler<priorities, clock_type>::run(idle_t idle) {
+        mStopped = false;
+        while (!mStopped) {
+            if (!run_once()) {
+                idle(next_wake_time());
+            }
+        }
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    typename Scheduler<priorities, clock_type>::time_point Scheduler<priorities, clock_type>::next_wake_time() const {
+        return mSleeping.empty() ? time_point::max() : mSleeping.front().mWakeTime;
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    bool Scheduler<priorities, clock_type>::idle() const {
+        for (std::size_t i = 0; i < priorities; i++) {
+            if (!mReady[i].empty()) {
+                return false;
+            }
+        }
+        return mSleeping.empty();
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    void Scheduler<priorities, clock_type>::expire(time_point now) {
+        while (!mSleeping.empty() && !(now < mSleeping.front().mWakeTime)) {
+            ready(mSleeping.front());
+        }
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    typename Scheduler<priorities, clock_type>::Task* Scheduler<priorities, clock_type>::pickNext() {
+        while (mReadyMap) {
+            const unsigned prio = highestBit(mReadyMap);
+            if (!mReady[prio].empty()) {
+                return &mReady[prio].front();
+            }
+            // emptied by a removal that bypassed the scheduler
+            mReadyMap &= ~(std::uint32_t(1) << prio);
+        }
+        return nullptr;
+    }
+
+    template<std::size_t priorities, typename clock_type>
+    unsigned Scheduler<priorities, clock_type>::highestBit(std::uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(31 - __builtin_clz(x));
+#else
+        unsigned i = 0;
+        while (x >>= 1) { i++; }
+        return i;
+#endif
+    }
+
+}
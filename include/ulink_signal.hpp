@@ -0,0 +1,171 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <cstddef>
+#include <utility>
+
+namespace ulink {
+
+    // observer list whose slots are nodes : connect and disconnect are O(1)
+    // link operations and emit() allocates nothing
+    //
+    // emit() walks the list with a cursor node of its own, moved past each
+    // slot before calling it, so a slot may disconnect itself or any other
+    // slot, connect new ones (appended, hence called by the running
+    // emission) or emit again while the signal is being emitted
+    template<typename... Args>
+    class Signal {
+
+    public:
+
+        // the callback is a plain function pointer given the slot itself,
+        // FunctionSlot wraps a function object for the lambda cases
+        class Slot : public Node<Slot> {
+
+        public:
+
+            using callback_t = void (*)(Slot& slot, Args... args);
+
+            explicit Slot(callback_t callback) : mCallback(callback) {}
+
+            Slot(const Slot& other) = delete;
+            Slot& operator=(const Slot& other) = delete;
+
+            bool connected() const { return this->isLinked(); }
+
+            void disconnect() { this->remove(); }
+
+        private:
+            friend class Signal;
+            // null for emission cursors
+            callback_t mCallback;
+        };
+
+        // slot calling a stored function object
+        template<typename function_t>
+        class FunctionSlot : public Slot {
+
+        public:
+
+            explicit FunctionSlot(function_t function) : Slot(&call), mFunction(std::move(function)) {}
+
+        private:
+
+            static void call(Slot& slot, Args... args) {
+                static_cast<FunctionSlot&>(slot).mFunction(args...);
+            }
+
+            function_t mFunction;
+        };
+
+        Signal() = default;
+
+        Signal(const Signal& other) = delete;
+        Signal& operator=(const Signal& other) = delete;
+
+        // appends "slot", reconnecting it if it was connected elsewhere
+        void connect(Slot& slot) { mSlots.push_back(slot); }
+
+        void disconnect(Slot& slot) { slot.remove(); }
+
+        // disconnects every slot, a running emission stops
+        void disconnect_all() { mSlots.clear(); }
+
+        // calls every connected slot in connection order
+        void emit(Args... args);
+
+        void operator()(Args... args) { emit(args...); }
+
+        bool empty() const;
+        std::size_t size() const;
+
+    private:
+        List<Slot> mSlots;
+    };
+
+    // FunctionSlot factory, "auto slot = ulink::make_slot<int>([] (int) {});"
+    template<typename... Args, typename function_t>
+    typename Signal<Args...>::template FunctionSlot<function_t> make_slot(function_t function) {
+        return typename Signal<Args...>::template FunctionSlot<function_t>(std::move(function));
+    }
+
+    template<typename... Args>
+    void Signal<Args...>::emit(Args... args) {
+
+        using iterator = typename List<Slot>::iterator;
+
+        Slot cursor(nullptr);
+        mSlots.push_front(cursor);
+
+        // the cursor is unlinked by disconnect_all()
+        while (cursor.isLinked()) {
+
+            iterator it(&cursor);
+            ++it;
+
+            if (it == mSlots.end()) {
+                break;
+            }
+
+            Slot& slot = *it;
+            mSlots.insert_after(it, cursor);
+
+            // skips the cursors of nested emissions
+            if (slot.mCallback) {
+                slot.mCallback(slot, args...);
+            }
+        }
+
+        cursor.remove();
+    }
+
+    template<typename... Args>
+    bool Signal<Args...>::empty() const {
+        for (const auto& slot : mSlots) {
+            if (slot.mCallback) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename... Args>
+    std::size_t Signal<Args...>::size() const {
+        std::size_t count = 0;
+        for (const auto& slot : mSlots) {
+            if (slot.mCallback) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+}
@@ -0,0 +1,343 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace ulink {
+
+    // forward declaration
+    template<typename T, std::size_t levels = 8>
+    struct SkipNode;
+
+    template<typename node_t, typename compare_t = std::less<node_t>>
+    class SkipList;
+
+    // non-owning ordered skip list
+    // level 0 is a plain ulink::List, so traversal costs the same as a List
+    template<typename node_t, typename compare_t>
+    class SkipList {
+
+        using hook_t = SkipNode<node_t, node_t::skip_levels>;
+
+        static_assert(
+            std::is_convertible_v<node_t*, hook_t*>,
+            "Node type error"
+            );
+
+        static constexpr std::size_t kTowerSize = node_t::skip_levels - 1;
+
+    public:
+
+        using iterator = typename List<node_t>::iterator;
+        using const_iterator = typename List<node_t>::const_iterator;
+        using reverse_iterator = typename List<node_t>::reverse_iterator;
+        using const_reverse_iterator = typename List<node_t>::const_reverse_iterator;
+        using value_type = node_t;
+        using size_type = std::size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using key_compare = compare_t;
+
+        SkipList(const compare_t& comp = compare_t());
+
+        SkipList(const SkipList& other) = delete;
+        SkipList& operator=(const SkipList& other) = delete;
+
+        iterator begin() { return mList.begin(); }
+        iterator end() { return mList.end(); }
+
+        const_iterator begin() const { return mList.begin(); }
+        const_iterator end() const { return mList.end(); }
+
+        reverse_iterator rbegin() { return mList.rbegin(); }
+        reverse_iterator rend() { return mList.rend(); }
+
+        const_reverse_iterator rbegin() const { return mList.rbegin(); }
+        const_reverse_iterator rend() const { return mList.rend(); }
+
+        reference front() { return mList.front(); }
+        reference back() { return mList.back(); }
+
+        const_reference front() const { return mList.front(); }
+        const_reference back() const { return mList.back(); }
+
+        size_type size() const { return mList.size(); }
+        bool empty() const { return mList.empty(); }
+        void clear();
+
+        // equivalent nodes are kept in insertion order
+        iterator insert(reference node);
+
+        // returns the iterator following the erased node
+        iterator erase(iterator pos);
+
+        void pop_front();
+        void pop_back();
+
+        // keys are compared with compare_t(node, key) and compare_t(key, node)
+        template<typename key_t>
+        iterator find(const key_t& key);
+
+        template<typename key_t>
+        iterator lower_bound(const key_t& key);
+
+        template<typename key_t>
+        iterator upper_bound(const key_t& key);
+
+        template<typename key_t>
+        std::pair<iterator, iterator> equal_range(const key_t& key);
+
+        ~SkipList() { clear(); }
+
+    private:
+
+        // fills "update" with the last node of each upper level that
+        // satisfies "before", then finishes the search on level 0
+        template<typename pred_t>
+        iterator search(pred_t before, hook_t** update);
+
+        std::size_t randomHeight();
+
+        static const node_t& value(const hook_t* n) { return *static_cast<const node_t*>(n); }
+
+        List<node_t> mList;
+        hook_t mHead;
+        compare_t mCompare;
+        std::uint32_t mSeed = 0x9E3779B9u;
+
+    };
+
+    template<typename node_t, typename compare_t>
+    SkipList<node_t, compare_t>::SkipList(const compare_t& comp) : mCompare(comp) {}
+
+    template<typename node_t, typename compare_t>
+    void SkipList<node_t, compare_t>::clear() {
+        while (!mList.empty()) {
+            static_cast<hook_t&>(mList.front()).remove();
+        }
+    }
+
+    template<typename node_t, typename compare_t>
+    typename SkipList<node_t, compare_t>::iterator SkipList<node_t, compare_t>::insert(reference node) {
+
+        hook_t& hook = node;
+        hook.remove();
+
+        hook_t* update[kTowerSize + 1];
+
+        auto pos = search(
+            [this, &node] (const node_t& n) { return !mCompare(node, n); },
+            update
+        );
+
+        mList.insert_before(pos, node);
+
+        const std::size_t height = randomHeight();
+
+        for (std::size_t l = 0; l < height; l++) {
+            auto* p = update[l];
+            auto* n = p->mNext[l];
+            hook.mPrev[l] = p;
+            hook.mNext[l] = n;
+            if (n) {
+                n->mPrev[l] = &hook;
+            }
+            p->mNext[l] = &hook;
+        }
+
+        hook.mHeight = static_cast<unsigned char>(height);
+
+        return iterator(&node);
+    }
+
+    template<typename node_t, typename compare_t>
+    typename SkipList<node_t, compare_t>::iterator SkipList<node_t, compare_t>::erase(iterator pos) {
+        if (pos == end()) {
+            return pos;
+        }
+        auto next = pos;
+        ++next;
+        static_cast<hook_t&>(*pos).remove();
+        return next;
+    }
+
+    template<typename node_t, typename compare_t>
+    void SkipList<node_t, compare_t>::pop_front() {
+        if (empty()) {
+            return;
+        }
+        static_cast<hook_t&>(mList.front()).remove();
+    }
+
+    template<typename node_t, typename compare_t>
+    void SkipList<node_t, compare_t>::pop_back() {
+        if (empty()) {
+            return;
+        }
+        static_cast<hook_t&>(mList.back()).remove();
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    typename SkipList<node_t, compare_t>::iterator SkipList<node_t, compare_t>::find(const key_t& key) {
+        auto it = lower_bound(key);
+        if (it == end() || mCompare(key, *it)) {
+            return end();
+        }
+        return it;
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    typename SkipList<node_t, compare_t>::iterator SkipList<node_t, compare_t>::lower_bound(const key_t& key) {
+        hook_t* update[kTowerSize + 1];
+        return search(
+            [this, &key] (const node_t& n) { return mCompare(n, key); },
+            update
+        );
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    typename SkipList<node_t, compare_t>::iterator SkipList<node_t, compare_t>::upper_bound(const key_t& key) {
+        hook_t* update[kTowerSize + 1];
+        return search(
+            [this, &key] (const node_t& n) { return !mCompare(key, n); },
+            update
+        );
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename key_t>
+    std::pair<typename SkipList<node_t, compare_t>::iterator, typename SkipList<node_t, compare_t>::iterator>
+        SkipList<node_t, compare_t>::equal_range(const key_t& key) {
+        auto first = lower_bound(key);
+        auto last = first;
+        while (last != end() && !mCompare(key, *last)) {
+            ++last;
+        }
+        return { first, last };
+    }
+
+    template<typename node_t, typename compare_t>
+    template<typename pred_t>
+    typename SkipList<node_t, compare_t>::iterator SkipList<node_t, compare_t>::search(pred_t before, hook_t** update) {
+
+        hook_t* x = &mHead;
+
+        for (std::size_t l = kTowerSize; l-- > 0;) {
+            while (x->mNext[l] && before(value(x->mNext[l]))) {
+                x = x->mNext[l];
+            }
+            update[l] = x;
+        }
+
+        iterator it = begin();
+
+        if (x != &mHead) {
+            it = iterator(static_cast<node_t*>(x));
+            ++it;
+        }
+
+        while (it != end() && before(*it)) {
+            ++it;
+        }
+
+        return it;
+    }
+
+    template<typename node_t, typename compare_t>
+    std::size_t SkipList<node_t, compare_t>::randomHeight() {
+
+        // xorshift32, each extra level has a probability of 1/4
+        mSeed ^= mSeed << 13;
+        mSeed ^= mSeed >> 17;
+        mSeed ^= mSeed << 5;
+
+        auto r = mSeed;
+        std::size_t height = 0;
+
+        while (height < kTowerSize && (r & 3) == 0) {
+            height++;
+            r >>= 2;
+        }
+
+        return height;
+    }
+
+
+
+
+    // hook for SkipList, a Node<T> extended with a tower of "levels - 1"
+    // doubly linked upper levels so that removal stays O(1)
+    // a list of n nodes is searched in O(log n) while n stays below 4^levels
+    template<typename T, std::size_t levels>
+    struct SkipNode : Node<T> {
+
+        static_assert(levels >= 2 && levels <= 16, "invalid level count");
+
+        static constexpr std::size_t skip_levels = levels;
+
+        void remove();
+
+        ~SkipNode() { remove(); }
+
+    protected:
+
+        template<typename node_t, typename compare_t>
+        friend class SkipList;
+
+        SkipNode* mPrev[levels - 1] = {};
+        SkipNode* mNext[levels - 1] = {};
+        unsigned char mHeight = 0;
+    };
+
+    template<typename T, std::size_t levels>
+    void SkipNode<T, levels>::remove() {
+
+        for (std::size_t l = 0; l < mHeight; l++) {
+            mPrev[l]->mNext[l] = mNext[l];
+            if (mNext[l]) {
+                mNext[l]->mPrev[l] = mPrev[l];
+            }
+            mPrev[l] = mNext[l] = nullptr;
+        }
+
+        mHeight = 0;
+
+        Node<T>::remove();
+    }
+
+}
@@ -0,0 +1,340 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace ulink {
+
+    // forward declaration
+    template<typename node_t>
+    class TaggedList;
+
+    // hook whose links carry "flag_count" user flags in their alignment
+    // bits, the first half in "next" and the others in "prev", so a couple
+    // of state bits cost no extra word : 3 bits per link on 64 bit targets,
+    // 2 on 32 bit ones
+    // the flags belong to the node, linking and unlinking preserve them
+    template<typename T, std::size_t flag_count = 2>
+    struct TaggedNode {
+
+        using tagged_hook_t = TaggedNode;
+
+        // alignment bits of one link
+        static constexpr std::size_t kLinkBits =
+            (alignof(std::uintptr_t) >= 8) ? 3 : (alignof(std::uintptr_t) >= 4) ? 2 : (alignof(std::uintptr_t) >= 2) ? 1 : 0;
+
+        static_assert(flag_count <= 2 * kLinkBits, "too many flags for the link alignment");
+
+        static constexpr std::size_t kNextFlags = (flag_count < kLinkBits) ? flag_count : kLinkBits;
+
+        void remove();
+
+        bool isLinked() const { return (prevLink() != nullptr); }
+
+        // only indexes below "flag_count" compile, a bit past them would
+        // belong to a link
+        template<std::size_t index, typename = std::enable_if_t<(index < flag_count)>>
+        bool flag() const;
+
+        template<std::size_t index, typename = std::enable_if_t<(index < flag_count)>>
+        void set_flag(bool value = true);
+
+        template<std::size_t index, typename = std::enable_if_t<(index < flag_count)>>
+        void clear_flag() { set_flag<index>(false); }
+
+        // all flags at once, flag "i" being bit "i", bits past "flag_count"
+        // are ignored
+        std::uint32_t flags() const;
+        void set_flags(std::uint32_t flags);
+
+        TaggedNode() = default;
+        TaggedNode(const TaggedNode&) {}
+        TaggedNode& operator=(const TaggedNode&) { return *this; }
+
+        ~TaggedNode() { remove(); }
+
+    protected:
+
+        template<typename node_t>
+        friend class TaggedList;
+
+        static constexpr std::uintptr_t kMask = (std::uintptr_t(1) << kLinkBits) - 1;
+
+        TaggedNode* prevLink() const { return reinterpret_cast<TaggedNode*>(mPrev & ~kMask); }
+        TaggedNode* nextLink() const { return reinterpret_cast<TaggedNode*>(mNext & ~kMask); }
+
+        void setPrev(TaggedNode* n) { mPrev = reinterpret_cast<std::uintptr_t>(n) | (mPrev & kMask); }
+        void setNext(TaggedNode* n) { mNext = reinterpret_cast<std::uintptr_t>(n) | (mNext & kMask); }
+
+        std::uintptr_t mPrev = 0;
+        std::uintptr_t mNext = 0;
+    };
+
+    template<typename T, std::size_t flag_count>
+    void TaggedNode<T, flag_count>::remove() {
+
+        TaggedNode* p = prevLink();
+        TaggedNode* n = nextLink();
+
+        if (p) {
+            p->setNext(n);
+        }
+
+        if (n) {
+            n->setPrev(p);
+        }
+
+        setPrev(nullptr);
+        setNext(nullptr);
+    }
+
+    template<typename T, std::size_t flag_count>
+    template<std::size_t index, typename>
+    bool TaggedNode<T, flag_count>::flag() const {
+        if constexpr (index < kNextFlags) {
+            return (mNext >> index) & 1;
+        }
+        else {
+            return (mPrev >> (index - kNextFlags)) & 1;
+        }
+    }
+
+    template<typename T, std::size_t flag_count>
+    template<std::size_t index, typename>
+    void TaggedNode<T, flag_count>::set_flag(bool value) {
+        std::uintptr_t& link = (index < kNextFlags) ? mNext : mPrev;
+        const std::uintptr_t bit = std::uintptr_t(1) << ((index < kNextFlags) ? index : index - kNextFlags);
+        link = value ? (link | bit) : (link & ~bit);
+    }
+
+    template<typename T, std::size_t flag_count>
+    std::uint32_t TaggedNode<T, flag_count>::flags() const {
+        constexpr std::uintptr_t nextMask = (std::uintptr_t(1) << kNextFlags) - 1;
+        constexpr std::uintptr_t prevMask = (std::uintptr_t(1) << (flag_count - kNextFlags)) - 1;
+        return static_cast<std::uint32_t>((mNext & nextMask) | ((mPrev & prevMask) << kNextFlags));
+    }
+
+    template<typename T, std::size_t flag_count>
+    void TaggedNode<T, flag_count>::set_flags(std::uint32_t flags) {
+        constexpr std::uintptr_t nextMask = (std::uintptr_t(1) << kNextFlags) - 1;
+        constexpr std::uintptr_t prevMask = (std::uintptr_t(1) << (flag_count - kNextFlags)) - 1;
+        mNext = (mNext & ~nextMask) | (flags & nextMask);
+        mPrev = (mPrev & ~prevMask) | ((flags >> kNextFlags) & prevMask);
+    }
+
+    // non-owning doubly linked list of TaggedNode hooks, with the core
+    // operations of ulink::List, every link access masking the flags
+    template<typename node_t>
+    class TaggedList {
+
+        using hook_t = typename node_t::tagged_hook_t;
+
+        static_assert(
+            std::is_convertible_v<node_t*, hook_t*>,
+            "Node type error"
+            );
+
+        template<bool is_forward, typename value_t, typename link_t>
+        struct Iterator {
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = node_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_t*;
+            using reference = value_t&;
+            Iterator() = default;
+            Iterator(link_t* n) : mNode(n) {}
+            value_t& operator*() const { return static_cast<value_t&>(*mNode); }
+            value_t* operator ->() const { return static_cast<value_t*>(mNode); }
+            Iterator& operator++() { mNode = is_forward ? mNode->nextLink() : mNode->prevLink(); return *this; }
+            Iterator& operator--() { mNode = is_forward ? mNode->prevLink() : mNode->nextLink(); return *this; }
+            Iterator operator++(int) { Iterator it = *this; ++(*this); return it; }
+            Iterator operator--(int) { Iterator it = *this; --(*this); return it; }
+            bool operator !=(const Iterator& it) const { return (mNode != it.mNode); }
+            bool operator ==(const Iterator& it) const { return (mNode == it.mNode); }
+            operator Iterator<is_forward, const value_t, const link_t>() const { return mNode; }
+        private:
+            friend class TaggedList;
+            link_t* mNode = nullptr;
+        };
+
+    public:
+
+        using iterator = Iterator<true, node_t, hook_t>;
+        using const_iterator = Iterator<true, const node_t, const hook_t>;
+        using reverse_iterator = Iterator<false, node_t, hook_t>;
+        using const_reverse_iterator = Iterator<false, const node_t, const hook_t>;
+        using value_type = node_t;
+        using size_type = std::size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        TaggedList();
+
+        TaggedList(const TaggedList& other) = delete;
+        TaggedList& operator=(const TaggedList& other) = delete;
+
+        iterator begin() { return iterator(mStartNode.nextLink()); }
+        iterator end() { return iterator(&mEndNode); }
+
+        const_iterator begin() const { return const_iterator(mStartNode.nextLink()); }
+        const_iterator end() const { return const_iterator(&mEndNode); }
+
+        reverse_iterator rbegin() { return reverse_iterator(mEndNode.prevLink()); }
+        reverse_iterator rend() { return reverse_iterator(&mStartNode); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(mEndNode.prevLink()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(&mStartNode); }
+
+        reference front() { return *begin(); }
+        reference back() { return *rbegin(); }
+
+        const_reference front() const { return *begin(); }
+        const_reference back() const { return *rbegin(); }
+
+        size_type size() const;
+        bool empty() const { return (mStartNode.nextLink() == &mEndNode); }
+        void clear();
+
+        void push_front(reference node) { insertAfter(mStartNode, node); }
+        void push_back(reference node) { insertBefore(mEndNode, node); }
+
+        void pop_front();
+        void pop_back();
+
+        void insert_before(iterator pos, reference node) { insertBefore(*pos.mNode, node); }
+        void insert_after(iterator pos, reference node) { insertAfter(*pos.mNode, node); }
+
+        // returns the iterator following "pos"
+        iterator erase(iterator pos);
+
+        // moves all the nodes of "other" before "pos"
+        void splice(iterator pos, TaggedList& other);
+
+        ~TaggedList() { clear(); }
+
+    private:
+
+        void insertAfter(hook_t& pos, hook_t& node);
+        void insertBefore(hook_t& pos, hook_t& node);
+
+        hook_t mStartNode;
+        hook_t mEndNode;
+
+    };
+
+    template<typename node_t>
+    TaggedList<node_t>::TaggedList() {
+        mStartNode.setNext(&mEndNode);
+        mEndNode.setPrev(&mStartNode);
+    }
+
+    template<typename node_t>
+    typename TaggedList<node_t>::size_type TaggedList<node_t>::size() const {
+        size_type s = 0;
+        for (auto it = begin(); it != end(); ++it) {
+            s++;
+        }
+        return s;
+    }
+
+    template<typename node_t>
+    void TaggedList<node_t>::clear() {
+        while (!empty()) {
+            pop_front();
+        }
+    }
+
+    template<typename node_t>
+    void TaggedList<node_t>::pop_front() {
+        if (!empty()) {
+            mStartNode.nextLink()->remove();
+        }
+    }
+
+    template<typename node_t>
+    void TaggedList<node_t>::pop_back() {
+        if (!empty()) {
+            mEndNode.prevLink()->remove();
+        }
+    }
+
+    template<typename node_t>
+    typename TaggedList<node_t>::iterator TaggedList<node_t>::erase(iterator pos) {
+        if (pos == end()) {
+            return pos;
+        }
+        iterator next = pos.mNode->nextLink();
+        pos.mNode->remove();
+        return next;
+    }
+
+    template<typename node_t>
+    void TaggedList<node_t>::splice(iterator pos, TaggedList& other) {
+
+        if (&other == this || other.empty()) {
+            return;
+        }
+
+        hook_t* first = other.mStartNode.nextLink();
+        hook_t* last = other.mEndNode.prevLink();
+        hook_t* before = pos.mNode->prevLink();
+
+        other.mStartNode.setNext(&other.mEndNode);
+        other.mEndNode.setPrev(&other.mStartNode);
+
+        before->setNext(first);
+        first->setPrev(before);
+        last->setNext(pos.mNode);
+        pos.mNode->setPrev(last);
+    }
+
+    template<typename node_t>
+    void TaggedList<node_t>::insertAfter(hook_t& pos, hook_t& node) {
+        node.remove();
+        hook_t* next = pos.nextLink();
+        node.setPrev(&pos);
+        node.setNext(next);
+        next->setPrev(&node);
+        pos.setNext(&node);
+    }
+
+    template<typename node_t>
+    void TaggedList<node_t>::insertBefore(hook_t& pos, hook_t& node) {
+        node.remove();
+        hook_t* prev = pos.prevLink();
+        node.setNext(&pos);
+        node.setPrev(prev);
+        prev->setNext(&node);
+        pos.setPrev(&node);
+    }
+
+}
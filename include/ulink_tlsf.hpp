@@ -0,0 +1,338 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace ulink {
+
+    namespace detail {
+
+        constexpr unsigned log2(std::size_t x) {
+            return (x > 1) ? 1 + log2(x >> 1) : 0;
+        }
+
+        // index of the least significant set bit, x != 0
+        inline unsigned lowestSetBit(std::uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctz(x));
+#else
+            unsigned i = 0;
+            while (!(x & 1u)) { x >>= 1; i++; }
+            return i;
+#endif
+        }
+
+        // index of the most significant set bit, x != 0
+        inline unsigned highestSetBit(std::size_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(x));
+#else
+            unsigned i = 0;
+            while (x >>= 1) { i++; }
+            return i;
+#endif
+        }
+
+    }
+
+    // two-level segregated fit allocator over a caller-supplied region
+    // allocate and deallocate run in bounded time : a size class is found
+    // with two bitmap scans and free blocks are merged with their physical
+    // neighbours immediately, the free lists being ulink lists
+    // blocks up to 2^max_log2 bytes, 2^sl_log2 lists per power of two
+    template<std::size_t max_log2 = 30, std::size_t sl_log2 = 4>
+    class Tlsf {
+
+        struct Block;
+        struct FreeBlock;
+
+    public:
+
+        using size_type = std::size_t;
+
+        static constexpr size_type alignment = alignof(std::max_align_t);
+
+        Tlsf(void* region, size_type size);
+
+        Tlsf(const Tlsf& other) = delete;
+        Tlsf& operator=(const Tlsf& other) = delete;
+
+        // nullptr when no free block is large enough
+        void* allocate(size_type size);
+
+        // ptr must come from this heap or be nullptr
+        void deallocate(void* ptr);
+
+        // payload size of an allocated block, at least the requested size
+        static size_type usable_size(const void* ptr);
+
+    private:
+
+        // used blocks only carry the header, the list hook of a free
+        // block lives in the first bytes of its payload
+        struct Block {
+            Block* prevPhys;
+            size_type sizeField;
+        };
+
+        struct FreeBlock : Block, Node<FreeBlock> {};
+
+        static constexpr size_type kFreeBit = 1;
+        static constexpr size_type kPrevFreeBit = 2;
+        static constexpr size_type kFlagMask = kFreeBit | kPrevFreeBit;
+
+        static constexpr size_type kHeaderSize = (sizeof(Block) + alignment - 1) & ~(alignment - 1);
+        static constexpr size_type kMinBlockSize = (sizeof(FreeBlock) - sizeof(Block) + alignment - 1) & ~(alignment - 1);
+
+        static constexpr unsigned kSlCount = 1u << sl_log2;
+        static constexpr unsigned kFlShift = static_cast<unsigned>(sl_log2) + detail::log2(alignment);
+        static constexpr size_type kSmallBlockSize = size_type(1) << kFlShift;
+        static constexpr unsigned kFlCount = static_cast<unsigned>(max_log2) - kFlShift + 1;
+        static constexpr size_type kMaxBlockSize = (size_type(1) << max_log2) - alignment;
+
+        static_assert(sl_log2 <= 5, "second level bitmap is 32 bits wide");
+        static_assert(kFlCount <= 32, "first level bitmap is 32 bits wide");
+        static_assert(max_log2 < sizeof(size_type) * 8, "max_log2 too large for size_t");
+        static_assert(kSmallBlockSize / kSlCount == alignment, "small blocks are mapped linearly");
+
+        static size_type sizeOf(const Block* b) { return b->sizeField & ~kFlagMask; }
+        static bool isFree(const Block* b) { return b->sizeField & kFreeBit; }
+        static bool isPrevFree(const Block* b) { return b->sizeField & kPrevFreeBit; }
+        static void setSize(Block* b, size_type s) { b->sizeField = s | (b->sizeField & kFlagMask); }
+        static void setFlag(Block* b, size_type flag, bool set) { b->sizeField = set ? (b->sizeField | flag) : (b->sizeField & ~flag); }
+
+        static void* payloadOf(Block* b) { return reinterpret_cast<char*>(b) + kHeaderSize; }
+        static Block* blockOf(const void* p) { return reinterpret_cast<Block*>(const_cast<char*>(static_cast<const char*>(p)) - kHeaderSize); }
+        static Block* nextPhys(Block* b) { return reinterpret_cast<Block*>(static_cast<char*>(payloadOf(b)) + sizeOf(b)); }
+
+        static void mappingInsert(size_type size, unsigned& fl, unsigned& sl);
+        static void mappingSearch(size_type size, unsigned& fl, unsigned& sl);
+
+        void insertFree(Block* b);
+        void removeFree(Block* b);
+        Block* findFree(unsigned& fl, unsigned& sl);
+
+        List<FreeBlock> mFree[kFlCount][kSlCount];
+        std::uint32_t mFlBitmap = 0;
+        std::uint32_t mSlBitmap[kFlCount] = {};
+
+    };
+
+    template<std::size_t max_log2, std::size_t sl_log2>
+    Tlsf<max_log2, sl_log2>::Tlsf(void* region, size_type size) {
+
+        auto start = reinterpret_cast<std::uintptr_t>(region);
+        const auto end = start + size;
+        start = (start + alignment - 1) & ~std::uintptr_t(alignment - 1);
+
+        if (end < start || end - start < 2 * kHeaderSize + kMinBlockSize) {
+            return;
+        }
+
+        // one free block spanning the region, then a zero sized used
+        // block that stops the forward merges
+        size_type blockSize = (end - start - 2 * kHeaderSize) & ~(alignment - 1);
+        if (blockSize > kMaxBlockSize) {
+            blockSize = kMaxBlockSize;
+        }
+
+        auto* first = reinterpret_cast<Block*>(start);
+        first->prevPhys = nullptr;
+        first->sizeField = blockSize;
+
+        auto* last = nextPhys(first);
+        last->prevPhys = first;
+        last->sizeField = 0;
+
+        setFlag(first, kFreeBit, true);
+        setFlag(last, kPrevFreeBit, true);
+        insertFree(first);
+    }
+
+    template<std::size_t max_log2, std::size_t sl_log2>
+    void* Tlsf<max_log2, sl_log2>::allocate(size_type size) {
+
+        if (size == 0 || size > kMaxBlockSize) {
+            return nullptr;
+        }
+
+        size = (size + alignment - 1) & ~(alignment - 1);
+        if (size < kMinBlockSize) {
+            size = kMinBlockSize;
+        }
+
+        unsigned fl;
+        unsigned sl;
+        mappingSearch(size, fl, sl);
+
+        if (fl >= kFlCount) {
+            return nullptr;
+        }
+
+        Block* b = findFree(fl, sl);
+        if (!b) {
+            return nullptr;
+        }
+
+        removeFree(b);
+
+        // give the tail back if it can hold a block of its own
+        if (sizeOf(b) >= size + kHeaderSize + kMinBlockSize) {
+            auto* rest = reinterpret_cast<Block*>(static_cast<char*>(payloadOf(b)) + size);
+            rest->prevPhys = b;
+            rest->sizeField = (sizeOf(b) - size - kHeaderSize) | kFreeBit;
+            setSize(b, size);
+            nextPhys(rest)->prevPhys = rest;
+            insertFree(rest);
+        }
+        else {
+            setFlag(nextPhys(b), kPrevFreeBit, false);
+        }
+
+        setFlag(b, kFreeBit, false);
+
+        return payloadOf(b);
+    }
+
+    template<std::size_t max_log2, std::size_t sl_log2>
+    void Tlsf<max_log2, sl_log2>::deallocate(void* ptr) {
+
+        if (!ptr) {
+            return;
+        }
+
+        Block* b = blockOf(ptr);
+
+        if (isPrevFree(b)) {
+            Block* prev = b->prevPhys;
+            removeFree(prev);
+            setSize(prev, sizeOf(prev) + kHeaderSize + sizeOf(b));
+            b = prev;
+            nextPhys(b)->prevPhys = b;
+        }
+
+        Block* next = nextPhys(b);
+
+        if (isFree(next)) {
+            removeFree(next);
+            setSize(b, sizeOf(b) + kHeaderSize + sizeOf(next));
+            nextPhys(b)->prevPhys = b;
+        }
+
+        setFlag(b, kFreeBit, true);
+        setFlag(nextPhys(b), kPrevFreeBit, true);
+        insertFree(b);
+    }
+
+    template<std::size_t max_log2, std::size_t sl_log2>
+    typename Tlsf<max_log2, sl_log2>::size_type Tlsf<max_log2, sl_log2>::usable_size(const void* ptr) {
+        return ptr ? sizeOf(blockOf(ptr)) : 0;
+    }
+
+    template<std::size_t max_log2, std::size_t sl_log2>
+    void Tlsf<max_log2, sl_log2>::mappingInsert(size_type size, unsigned& fl, unsigned& sl) {
+        if (size < kSmallBlockSize) {
+            fl = 0;
+            sl = static_cast<unsigned>(size / alignment);
+        }
+        else {
+            const unsigned msb = detail::highestSetBit(size);
+            sl = static_cast<unsigned>(size >> (msb - sl_log2)) ^ kSlCount;
+            fl = msb - kFlShift + 1;
+        }
+    }
+
+    template<std::size_t max_log2, std::size_t sl_log2>
+    void Tlsf<max_log2, sl_log2>::mappingSearch(size_type size, unsigned& fl, unsigned& sl) {
+        // round up to the next list so that any block found is large enough
+        if (size >= kSmallBlockSize) {
+            size += (size_type(1) << (detail::highestSetBit(size) - sl_log2)) - 1;
+        }
+        mappingInsert(size, fl, sl);
+    }
+
+    template<std::size_t max_log2, std::size_t sl_log2>
+    void Tlsf<max_log2, sl_log2>::insertFree(Block* b) {
+
+        unsigned fl;
+        unsigned sl;
+        mappingInsert(sizeOf(b), fl, sl);
+
+        // the hook is (re)constructed over the start of the payload
+        const Block header = *b;
+        auto* f = new (b) FreeBlock;
+        f->prevPhys = header.prevPhys;
+        f->sizeField = header.sizeField;
+
+        mFree[fl][sl].push_front(*f);
+        mFlBitmap |= 1u << fl;
+        mSlBitmap[fl] |= 1u << sl;
+    }
+
+    template<std::size_t max_log2, std::size_t sl_log2>
+    void Tlsf<max_log2, sl_log2>::removeFree(Block* b) {
+
+        unsigned fl;
+        unsigned sl;
+        mappingInsert(sizeOf(b), fl, sl);
+
+        static_cast<FreeBlock*>(b)->remove();
+
+        if (mFree[fl][sl].empty()) {
+            mSlBitmap[fl] &= ~(1u << sl);
+            if (!mSlBitmap[fl]) {
+                mFlBitmap &= ~(1u << fl);
+            }
+        }
+    }
+
+    template<std::size_t max_log2, std::size_t sl_log2>
+    typename Tlsf<max_log2, sl_log2>::Block* Tlsf<max_log2, sl_log2>::findFree(unsigned& fl, unsigned& sl) {
+
+        std::uint32_t slMap = (sl < 32) ? (mSlBitmap[fl] & (~0u << sl)) : 0;
+
+        if (!slMap) {
+            const std::uint32_t flMap = (fl + 1 < 32) ? (mFlBitmap & (~0u << (fl + 1))) : 0;
+            if (!flMap) {
+                return nullptr;
+            }
+            fl = detail::lowestSetBit(flMap);
+            slMap = mSlBitmap[fl];
+        }
+
+        sl = detail::lowestSetBit(slMap);
+
+        return &mFree[fl][sl].front();
+    }
+
+}
@@ -0,0 +1,519 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include "ulink.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace ulink {
+
+    // sequence of pointers to objects that carry no hook, stored K per
+    // cache line aligned block, the blocks being chained by ulink::Node hooks
+    // default K fills one 64 bytes line next to the hook and the bounds : 5
+    // pointers on 64 bit targets, 13 on 32 bit ones
+    //
+    // blocks come from a BlockPool that the caller fills with storage of its
+    // own, they are taken when a push needs room and given back as soon as
+    // they are emptied, so several lists may share one pool
+    // a push returns false when the pool is exhausted
+    template<
+        typename T,
+        std::size_t K = (64 - 3 * sizeof(void*)) / sizeof(T)
+    >
+    class UnrolledList {
+
+        static_assert(std::is_pointer_v<T>, "UnrolledList stores pointers");
+        static_assert(K > 0 && K <= UINT16_MAX, "block size error");
+
+    public:
+
+        // items live in [mBegin, mEnd) so both ends grow in O(1)
+        struct alignas(64) Block : Node<Block> {
+            std::uint16_t mBegin = 0;
+            std::uint16_t mEnd = 0;
+            T mItems[K];
+        };
+
+        // free blocks chained through their own hook
+        class BlockPool {
+        public:
+
+            BlockPool() = default;
+
+            BlockPool(const BlockPool& other) = delete;
+            BlockPool& operator=(const BlockPool& other) = delete;
+
+            // "blocks" must outlive the pool and the lists using it
+            void add(Block* blocks, std::size_t count) {
+                for (std::size_t i = 0; i < count; i++) {
+                    mFree.push_back(blocks[i]);
+                }
+            }
+
+            std::size_t available() const { return mFree.size(); }
+
+        private:
+
+            friend class UnrolledList;
+
+            Block* acquire() {
+                if (mFree.empty()) {
+                    return nullptr;
+                }
+                Block& b = mFree.front();
+                mFree.pop_front();
+                return &b;
+            }
+
+            void release(Block& b) { mFree.push_front(b); }
+
+            List<Block> mFree;
+        };
+
+    private:
+
+        using block_list_t = List<Block>;
+
+        template<typename value_t, typename block_iterator_t>
+        struct Iterator {
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_t*;
+            using reference = value_t&;
+            Iterator() = default;
+            Iterator(block_iterator_t block, std::size_t index) : mBlock(block), mIndex(index) {}
+            value_t& operator*() const { return mBlock->mItems[mIndex]; }
+            value_t* operator ->() const { return &mBlock->mItems[mIndex]; }
+            Iterator& operator++() {
+                if (++mIndex == mBlock->mEnd) {
+                    ++mBlock;
+                    mIndex = 0;
+                    // the end sentinel is not a block
+                    if (mBlock != mBlockEnd) {
+                        mIndex = mBlock->mBegin;
+                    }
+                }
+                return *this;
+            }
+            Iterator& operator--() {
+                if (mBlock == mBlockEnd || mIndex == mBlock->mBegin) {
+                    --mBlock;
+                    mIndex = mBlock->mEnd;
+                }
+                mIndex--;
+                return *this;
+            }
+            Iterator operator++(int) { Iterator it = *this; ++(*this); return it; }
+            Iterator operator--(int) { Iterator it = *this; --(*this); return it; }
+            bool operator !=(const Iterator& it) const { return (mBlock != it.mBlock || mIndex != it.mIndex); }
+            bool operator ==(const Iterator& it) const { return (mBlock == it.mBlock && mIndex == it.mIndex); }
+            operator Iterator<const value_t, typename block_list_t::const_iterator>() const {
+                Iterator<const value_t, typename block_list_t::const_iterator> it(mBlock, mIndex);
+                it.mBlockEnd = mBlockEnd;
+                return it;
+            }
+        private:
+            friend class UnrolledList;
+            template<typename, typename>
+            friend struct Iterator;
+            block_iterator_t mBlock;
+            block_iterator_t mBlockEnd;
+            std::size_t mIndex = 0;
+        };
+
+    public:
+
+        using iterator = Iterator<T, typename block_list_t::iterator>;
+        using const_iterator = Iterator<const T, typename block_list_t::const_iterator>;
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        static constexpr size_type block_size() { return K; }
+
+        explicit UnrolledList(BlockPool& pool) : mPool(pool) {}
+
+        UnrolledList(const UnrolledList& other) = delete;
+        UnrolledList& operator=(const UnrolledList& other) = delete;
+
+        iterator begin();
+        iterator end() { return makeIterator(mBlocks.end(), 0); }
+
+        const_iterator begin() const;
+        const_iterator end() const { return makeIterator(mBlocks.end(), 0); }
+
+        reference front() { return *begin(); }
+        reference back() { return *(--end()); }
+
+        const_reference front() const { return *begin(); }
+        const_reference back() const { return *(--end()); }
+
+        // O(1), counted
+        size_type size() const { return mSize; }
+        bool empty() const { return (mSize == 0); }
+
+        // number of blocks in use
+        size_type block_count() const { return mBlocks.size(); }
+
+        // gives every block back to the pool
+        void clear();
+
+        bool push_front(value_type value);
+        bool push_back(value_type value);
+
+        void pop_front();
+        void pop_back();
+
+        // returns the iterator following "pos", shifting the shorter side
+        // of its block, a block left less than half full is merged with a
+        // neighbour or takes pointers from it
+        iterator erase(iterator pos);
+
+        // erases every pointer for which pred(pointer) is true, returns
+        // their count, the kept pointers are packed into as few blocks as
+        // possible
+        template<typename pred_t>
+        size_type erase_if(pred_t pred);
+
+        ~UnrolledList() { clear(); }
+
+    private:
+
+        iterator makeIterator(typename block_list_t::iterator block, std::size_t index) {
+            iterator it(block, index);
+            it.mBlockEnd = mBlocks.end();
+            return it;
+        }
+
+        const_iterator makeIterator(typename block_list_t::const_iterator block, std::size_t index) const {
+            const_iterator it(block, index);
+            it.mBlockEnd = mBlocks.end();
+            return it;
+        }
+
+        static std::size_t itemCount(const Block& b) { return b.mEnd - b.mBegin; }
+
+        // moves the items of "b" to the start of its storage
+        static void packFront(Block& b);
+
+        // rebalances "b" with a neighbour when it is less than half full,
+        // "pos" is kept on the same item
+        void rebalance(typename block_list_t::iterator b, iterator& pos);
+
+        void releaseBlock(Block& b);
+
+        BlockPool& mPool;
+        block_list_t mBlocks;
+        size_type mSize = 0;
+
+    };
+
+    template<typename T, std::size_t K>
+    typename UnrolledList<T, K>::iterator UnrolledList<T, K>::begin() {
+        if (mBlocks.empty()) {
+            return end();
+        }
+        return makeIterator(mBlocks.begin(), mBlocks.front().mBegin);
+    }
+
+    template<typename T, std::size_t K>
+    typename UnrolledList<T, K>::const_iterator UnrolledList<T, K>::begin() const {
+        if (mBlocks.empty()) {
+            return end();
+        }
+        return makeIterator(mBlocks.begin(), mBlocks.front().mBegin);
+    }
+
+    template<typename T, std::size_t K>
+    void UnrolledList<T, K>::clear() {
+        while (!mBlocks.empty()) {
+            releaseBlock(mBlocks.front());
+        }
+        mSize = 0;
+    }
+
+    template<typename T, std::size_t K>
+    bool UnrolledList<T, K>::push_front(value_type value) {
+
+        if (mBlocks.empty() || mBlocks.front().mBegin == 0) {
+            Block* b = mPool.acquire();
+            if (!b) {
+                return false;
+            }
+            b->mBegin = b->mEnd = K;
+            mBlocks.push_front(*b);
+        }
+
+        Block& b = mBlocks.front();
+        b.mItems[--b.mBegin] = value;
+        mSize++;
+        return true;
+    }
+
+    template<typename T, std::size_t K>
+    bool UnrolledList<T, K>::push_back(value_type value) {
+
+        if (mBlocks.empty() || mBlocks.back().mEnd == K) {
+            Block* b = mPool.acquire();
+            if (!b) {
+                return false;
+            }
+            b->mBegin = b->mEnd = 0;
+            mBlocks.push_back(*b);
+        }
+
+        Block& b = mBlocks.back();
+        b.mItems[b.mEnd++] = value;
+        mSize++;
+        return true;
+    }
+
+    template<typename T, std::size_t K>
+    void UnrolledList<T, K>::pop_front() {
+
+        if (empty()) {
+            return;
+        }
+
+        Block& b = mBlocks.front();
+        if (++b.mBegin == b.mEnd) {
+            releaseBlock(b);
+        }
+        mSize--;
+    }
+
+    template<typename T, std::size_t K>
+    void UnrolledList<T, K>::pop_back() {
+
+        if (empty()) {
+            return;
+        }
+
+        Block& b = mBlocks.back();
+        if (--b.mEnd == b.mBegin) {
+            releaseBlock(b);
+        }
+        mSize--;
+    }
+
+    template<typename T, std::size_t K>
+    typename UnrolledList<T, K>::iterator UnrolledList<T, K>::erase(iterator pos) {
+
+        if (pos.mBlock == mBlocks.end()) {
+            return pos;
+        }
+
+        Block& b = *pos.mBlock;
+        std::size_t i = pos.mIndex;
+
+        mSize--;
+
+        if (b.mEnd - b.mBegin == 1) {
+            auto next = std::next(pos.mBlock);
+            releaseBlock(b);
+            return makeIterator(next, (next == mBlocks.end()) ? 0 : next->mBegin);
+        }
+
+        if (i - b.mBegin < b.mEnd - 1 - i) {
+            // front side is shorter : shift it right
+            for (std::size_t j = i; j > b.mBegin; j--) {
+                b.mItems[j] = b.mItems[j - 1];
+            }
+            b.mBegin++;
+            i++;
+        }
+        else {
+            for (std::size_t j = i + 1; j < b.mEnd; j++) {
+                b.mItems[j - 1] = b.mItems[j];
+            }
+            b.mEnd--;
+        }
+
+        iterator next = makeIterator(pos.mBlock, i);
+
+        if (i == b.mEnd) {
+            auto n = std::next(pos.mBlock);
+            next = makeIterator(n, (n == mBlocks.end()) ? 0 : n->mBegin);
+        }
+
+        rebalance(pos.mBlock, next);
+
+        return next;
+    }
+
+    template<typename T, std::size_t K>
+    template<typename pred_t>
+    typename UnrolledList<T, K>::size_type UnrolledList<T, K>::erase_if(pred_t pred) {
+
+        size_type count = 0;
+
+        if (mBlocks.empty()) {
+            return count;
+        }
+
+        // the kept pointers are written densely from the first item on,
+        // the write position never passes the read position
+        auto w = mBlocks.begin();
+        std::size_t out = w->mBegin;
+
+        for (auto& b : mBlocks) {
+
+            const std::size_t first = b.mBegin;
+            const std::size_t last = b.mEnd;
+
+            for (std::size_t i = first; i < last; i++) {
+
+                if (pred(b.mItems[i])) {
+                    count++;
+                    continue;
+                }
+
+                if (out == K) {
+                    w->mEnd = K;
+                    ++w;
+                    w->mBegin = 0;
+                    out = 0;
+                }
+
+                w->mItems[out++] = b.mItems[i];
+            }
+        }
+
+        w->mEnd = static_cast<std::uint16_t>(out);
+
+        // the blocks past the write position are empty
+        while (&mBlocks.back() != &*w) {
+            releaseBlock(mBlocks.back());
+        }
+        if (w->mBegin == w->mEnd) {
+            releaseBlock(*w);
+        }
+
+        mSize -= count;
+        return count;
+    }
+
+    template<typename T, std::size_t K>
+    void UnrolledList<T, K>::packFront(Block& b) {
+        if (b.mBegin == 0) {
+            return;
+        }
+        const std::size_t n = itemCount(b);
+        for (std::size_t j = 0; j < n; j++) {
+            b.mItems[j] = b.mItems[b.mBegin + j];
+        }
+        b.mBegin = 0;
+        b.mEnd = static_cast<std::uint16_t>(n);
+    }
+
+    template<typename T, std::size_t K>
+    void UnrolledList<T, K>::rebalance(typename block_list_t::iterator b, iterator& pos) {
+
+        if (itemCount(*b) >= K / 2) {
+            return;
+        }
+
+        // pairs "b" with the following block, or the previous one for the last block
+        auto left = b;
+        auto right = std::next(b);
+        if (right == mBlocks.end()) {
+            if (b == mBlocks.begin()) {
+                return;
+            }
+            right = b;
+            --left;
+        }
+
+        Block& l = *left;
+        Block& r = *right;
+
+        // "pos" is tracked as an offset into the pair, the order being kept
+        const bool inPair = (pos.mBlock == left || pos.mBlock == right);
+        const std::size_t offset = (pos.mBlock == left) ?
+            pos.mIndex - l.mBegin :
+            itemCount(l) + pos.mIndex - r.mBegin;
+
+        const std::size_t total = itemCount(l) + itemCount(r);
+
+        if (total <= K) {
+            // merge into the left block
+            packFront(l);
+            for (std::size_t j = r.mBegin; j < r.mEnd; j++) {
+                l.mItems[l.mEnd++] = r.mItems[j];
+            }
+            releaseBlock(r);
+        }
+        else if (itemCount(l) < total / 2) {
+            // take the front of the right block
+            const std::size_t moved = total / 2 - itemCount(l);
+            packFront(l);
+            for (std::size_t j = 0; j < moved; j++) {
+                l.mItems[l.mEnd++] = r.mItems[r.mBegin++];
+            }
+        }
+        else {
+            // take the back of the left block
+            const std::size_t moved = itemCount(l) - total / 2;
+            if (r.mBegin < moved) {
+                const std::size_t n = itemCount(r);
+                for (std::size_t j = n; j > 0; j--) {
+                    r.mItems[K - n + j - 1] = r.mItems[r.mBegin + j - 1];
+                }
+                r.mBegin = static_cast<std::uint16_t>(K - n);
+                r.mEnd = K;
+            }
+            for (std::size_t j = 0; j < moved; j++) {
+                r.mItems[--r.mBegin] = l.mItems[--l.mEnd];
+            }
+        }
+
+        if (!inPair) {
+            return;
+        }
+
+        if (offset < itemCount(l)) {
+            pos = makeIterator(left, l.mBegin + offset);
+        }
+        else {
+            pos = makeIterator(right, r.mBegin + offset - itemCount(l));
+        }
+    }
+
+    template<typename T, std::size_t K>
+    void UnrolledList<T, K>::releaseBlock(Block& b) {
+        b.remove();
+        mPool.release(b);
+    }
+
+}
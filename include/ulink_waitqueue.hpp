@@ -0,0 +1,287 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#if !defined(__linux__)
+#error "ulink_waitqueue.hpp parks threads on Linux futexes"
+#endif
+
+#include "ulink.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <type_traits>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace ulink {
+
+    // FIFO queue of blocked threads, the waiters being nodes that live on
+    // the stack of the waiting threads
+    // threads are parked with FUTEX_WAIT on their own waiter, so a wake-up
+    // only touches the thread being woken
+    //
+    // a waiter is enqueued before the wake-up condition is checked, which
+    // avoids lost wake-ups :
+    //
+    //     WaitQueue::Waiter w;
+    //     q.prepare(w);
+    //     if (!condition) q.park(w);
+    //     q.finish(w);
+    //
+    // wait(pred) and wait(lock) wrap that sequence
+    class WaitQueue {
+
+    public:
+
+        struct Waiter : Node<Waiter> {
+            Waiter() = default;
+            Waiter(const Waiter&) = delete;
+            Waiter& operator=(const Waiter&) = delete;
+
+            // leaving the scope dequeues the waiter under the queue lock
+            ~Waiter() { if (mQueue) mQueue->finish(*this); }
+
+            bool signaled() const { return mState.load(std::memory_order_acquire) != 0; }
+
+        private:
+            friend class WaitQueue;
+            WaitQueue* mQueue = nullptr;
+            std::atomic<std::uint32_t> mState { 0 };
+        };
+
+        using size_type = std::size_t;
+
+        WaitQueue() = default;
+
+        WaitQueue(const WaitQueue& other) = delete;
+        WaitQueue& operator=(const WaitQueue& other) = delete;
+
+        // enqueues "w" at the back, clearing its signaled state
+        void prepare(Waiter& w);
+
+        // blocks until "w" is woken
+        void park(Waiter& w);
+
+        // blocks until "w" is woken or the timeout expires, returns
+        // false on timeout
+        bool park_for(Waiter& w, std::chrono::nanoseconds timeout);
+
+        // dequeues "w" if it is still queued, returns true if it was woken
+        bool finish(Waiter& w);
+
+        // blocks until pred() is true
+        template<typename pred_t, typename = std::enable_if_t<std::is_invocable_r_v<bool, pred_t&>>>
+        void wait(pred_t pred);
+
+        // returns pred(), false when the timeout expired first
+        template<typename pred_t, typename = std::enable_if_t<std::is_invocable_r_v<bool, pred_t&>>>
+        bool wait_for(pred_t pred, std::chrono::nanoseconds timeout);
+
+        // condition variable style : "lock" is released while blocked
+        template<typename lock_t, typename = std::enable_if_t<!std::is_invocable_v<lock_t&>>>
+        void wait(lock_t& lock);
+
+        template<typename lock_t, typename = std::enable_if_t<!std::is_invocable_v<lock_t&>>>
+        bool wait_for(lock_t& lock, std::chrono::nanoseconds timeout);
+
+        // wakes the oldest waiter, returns false if there was none
+        bool notify_one();
+
+        // wakes every waiter, returns their number
+        size_type notify_all();
+
+        bool empty() const;
+        size_type size() const;
+
+        ~WaitQueue() { notify_all(); }
+
+    private:
+
+        static void futexWait(std::atomic<std::uint32_t>& word, const timespec* timeout);
+        static void futexWake(std::atomic<std::uint32_t>& word);
+
+        // unlinks, signals and unparks the front waiter, lock held
+        void wakeFront();
+
+        List<Waiter> mWaiters;
+        mutable std::mutex mLock;
+
+    };
+
+    inline void WaitQueue::prepare(Waiter& w) {
+        std::lock_guard<std::mutex> guard(mLock);
+        w.mQueue = this;
+        w.mState.store(0, std::memory_order_relaxed);
+        mWaiters.push_back(w);
+    }
+
+    inline void WaitQueue::park(Waiter& w) {
+        // futex wake-ups may be spurious
+        while (!w.signaled()) {
+            futexWait(w.mState, nullptr);
+        }
+    }
+
+    inline bool WaitQueue::park_for(Waiter& w, std::chrono::nanoseconds timeout) {
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        while (!w.signaled()) {
+
+            const auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero()) {
+                return false;
+            }
+
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+            timespec ts;
+            ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+            ts.tv_nsec = static_cast<long>(ns % 1000000000);
+            futexWait(w.mState, &ts);
+        }
+
+        return true;
+    }
+
+    inline bool WaitQueue::finish(Waiter& w) {
+        std::lock_guard<std::mutex> guard(mLock);
+        // a notification racing with a timeout still counts
+        w.remove();
+        w.mQueue = nullptr;
+        return w.signaled();
+    }
+
+    template<typename pred_t, typename>
+    void WaitQueue::wait(pred_t pred) {
+        Waiter w;
+        for (;;) {
+            prepare(w);
+            if (pred()) {
+                break;
+            }
+            park(w);
+        }
+        finish(w);
+    }
+
+    template<typename pred_t, typename>
+    bool WaitQueue::wait_for(pred_t pred, std::chrono::nanoseconds timeout) {
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        Waiter w;
+
+        for (;;) {
+            prepare(w);
+            if (pred()) {
+                break;
+            }
+            if (!park_for(w, deadline - std::chrono::steady_clock::now())) {
+                finish(w);
+                return pred();
+            }
+        }
+
+        finish(w);
+        return true;
+    }
+
+    template<typename lock_t, typename>
+    void WaitQueue::wait(lock_t& lock) {
+        Waiter w;
+        prepare(w);
+        lock.unlock();
+        park(w);
+        finish(w);
+        lock.lock();
+    }
+
+    template<typename lock_t, typename>
+    bool WaitQueue::wait_for(lock_t& lock, std::chrono::nanoseconds timeout) {
+        Waiter w;
+        prepare(w);
+        lock.unlock();
+        park_for(w, timeout);
+        const bool woken = finish(w);
+        lock.lock();
+        return woken;
+    }
+
+    inline bool WaitQueue::notify_one() {
+        std::lock_guard<std::mutex> guard(mLock);
+        if (mWaiters.empty()) {
+            return false;
+        }
+        wakeFront();
+        return true;
+    }
+
+    inline WaitQueue::size_type WaitQueue::notify_all() {
+        std::lock_guard<std::mutex> guard(mLock);
+        size_type count = 0;
+        while (!mWaiters.empty()) {
+            wakeFront();
+            count++;
+        }
+        return count;
+    }
+
+    inline bool WaitQueue::empty() const {
+        std::lock_guard<std::mutex> guard(mLock);
+        return mWaiters.empty();
+    }
+
+    inline WaitQueue::size_type WaitQueue::size() const {
+        std::lock_guard<std::mutex> guard(mLock);
+        return mWaiters.size();
+    }
+
+    inline void WaitQueue::wakeFront() {
+        // the waiter cannot leave finish() while the lock is held, so it
+        // is still alive when the futex is woken
+        Waiter& w = mWaiters.front();
+        w.remove();
+        w.mState.store(1, std::memory_order_release);
+        futexWake(w.mState);
+    }
+
+    inline void WaitQueue::futexWait(std::atomic<std::uint32_t>& word, const timespec* timeout) {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, 0u, timeout, nullptr, 0);
+    }
+
+    inline void WaitQueue::futexWake(std::atomic<std::uint32_t>& word) {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+
+}
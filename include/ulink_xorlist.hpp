@@ -0,0 +1,341 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * MIT License                                                                     *
+ *                                                                                 *
+ * Copyright (c) 2024 Thomas AUBERT                                                *
+ *                                                                                 *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy    *
+ * of this software and associated documentation files (the "Software"), to deal   *
+ * in the Software without restriction, including without limitation the rights    *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+ * copies of the Software, and to permit persons to whom the Software is           *
+ * furnished to do so, subject to the following conditions:                        *
+ *                                                                                 *
+ * The above copyright notice and this permission notice shall be included in all  *
+ * copies or substantial portions of the Software.                                 *
+ *                                                                                 *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+ * SOFTWARE.                                                                       *
+ *                                                                                 *
+ * github : https://github.com/ThomasAUB/ulink                                     *
+ *                                                                                 *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace ulink {
+
+    // forward declaration
+    template<typename node_t>
+    class XorList;
+
+    // hook of a single word : the address of the previous node xor the
+    // address of the next one, null at both ends
+    // a node alone cannot find its neighbours, so unlike ulink::Node it has
+    // no remove() and does not unlink itself at destruction : it must be
+    // erased from its list first
+    template<typename T>
+    struct XorNode {
+
+    protected:
+
+        template<typename node_t>
+        friend class XorList;
+
+        std::uintptr_t mLink = 0;
+    };
+
+    // non-owning doubly linked list of XorNode hooks
+    //
+    // O(1) : push / pop at both ends, insert and erase at an iterator (it
+    // carries both neighbours), whole list splice, reverse
+    // O(n) : remove(node) and contains(node) which search the node, size()
+    //
+    // inserting or erasing invalidates the iterators to the neighbouring
+    // nodes, as they hold the address of their predecessor
+    template<typename node_t>
+    class XorList {
+
+        using hook_t = XorNode<node_t>;
+
+        static_assert(
+            std::is_convertible_v<node_t*, hook_t*>,
+            "Node type error"
+            );
+
+        static hook_t* other(const hook_t* n, const hook_t* neighbour) {
+            return reinterpret_cast<hook_t*>(n->mLink ^ reinterpret_cast<std::uintptr_t>(neighbour));
+        }
+
+        static std::uintptr_t address(const hook_t* n) { return reinterpret_cast<std::uintptr_t>(n); }
+
+        // walks from "node" away from "from", both directions share the
+        // same walk but have distinct types : "from" is the successor of a
+        // reverse iterator, which the mutators could not tell
+        template<typename value_t, bool is_forward>
+        struct Iterator {
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = node_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_t*;
+            using reference = value_t&;
+            Iterator() = default;
+            Iterator(hook_t* from, hook_t* node) : mFrom(from), mNode(node) {}
+            value_t& operator*() const { return static_cast<value_t&>(*mNode); }
+            value_t* operator ->() const { return static_cast<value_t*>(mNode); }
+            Iterator& operator++() { hook_t* n = other(mNode, mFrom); mFrom = mNode; mNode = n; return *this; }
+            Iterator& operator--() { hook_t* n = other(mFrom, mNode); mNode = mFrom; mFrom = n; return *this; }
+            Iterator operator++(int) { Iterator it = *this; ++(*this); return it; }
+            Iterator operator--(int) { Iterator it = *this; --(*this); return it; }
+            bool operator !=(const Iterator& it) const { return (mNode != it.mNode); }
+            bool operator ==(const Iterator& it) const { return (mNode == it.mNode); }
+            operator Iterator<const value_t, is_forward>() const { return Iterator<const value_t, is_forward>(mFrom, mNode); }
+        private:
+            friend class XorList;
+            hook_t* mFrom = nullptr;
+            hook_t* mNode = nullptr;
+        };
+
+    public:
+
+        using iterator = Iterator<node_t, true>;
+        using const_iterator = Iterator<const node_t, true>;
+        using reverse_iterator = Iterator<node_t, false>;
+        using const_reverse_iterator = Iterator<const node_t, false>;
+        using value_type = node_t;
+        using size_type = std::size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        XorList() = default;
+
+        XorList(const XorList& other) = delete;
+        XorList& operator=(const XorList& other) = delete;
+
+        iterator begin() { return iterator(nullptr, mHead); }
+        iterator end() { return iterator(mTail, nullptr); }
+
+        const_iterator begin() const { return const_iterator(nullptr, mHead); }
+        const_iterator end() const { return const_iterator(mTail, nullptr); }
+
+        reverse_iterator rbegin() { return reverse_iterator(nullptr, mTail); }
+        reverse_iterator rend() { return reverse_iterator(mHead, nullptr); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(nullptr, mTail); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(mHead, nullptr); }
+
+        reference front() { return static_cast<reference>(*mHead); }
+        reference back() { return static_cast<reference>(*mTail); }
+
+        const_reference front() const { return static_cast<const_reference>(*mHead); }
+        const_reference back() const { return static_cast<const_reference>(*mTail); }
+
+        size_type size() const;
+        bool empty() const { return (mHead == nullptr); }
+        void clear();
+
+        void push_front(reference node) { link(nullptr, node, mHead); }
+        void push_back(reference node) { link(mTail, node, nullptr); }
+
+        void pop_front();
+        void pop_back();
+
+        // returns the inserted node
+        iterator insert_before(iterator pos, reference node);
+        iterator insert_after(iterator pos, reference node);
+
+        // returns the iterator following "pos"
+        iterator erase(iterator pos);
+
+        // O(n), returns false if "node" is not in the list
+        bool remove(reference node);
+        bool contains(const_reference node) const;
+
+        // moves all the nodes of "other" before "pos"
+        void splice(iterator pos, XorList& other);
+
+        // swaps both ends
+        void reverse();
+
+        ~XorList() { clear(); }
+
+    private:
+
+        // links "node" between the adjacent "before" and "after"
+        void link(hook_t* before, hook_t& node, hook_t* after);
+
+        hook_t* mHead = nullptr;
+        hook_t* mTail = nullptr;
+
+    };
+
+    template<typename node_t>
+    typename XorList<node_t>::size_type XorList<node_t>::size() const {
+        size_type s = 0;
+        for (auto it = begin(); it != end(); ++it) {
+            s++;
+        }
+        return s;
+    }
+
+    template<typename node_t>
+    void XorList<node_t>::clear() {
+        hook_t* from = nullptr;
+        hook_t* n = mHead;
+        while (n) {
+            hook_t* next = other(n, from);
+            from = n;
+            n->mLink = 0;
+            n = next;
+        }
+        mHead = mTail = nullptr;
+    }
+
+    template<typename node_t>
+    void XorList<node_t>::pop_front() {
+        if (!empty()) {
+            erase(begin());
+        }
+    }
+
+    template<typename node_t>
+    void XorList<node_t>::pop_back() {
+        if (!empty()) {
+            erase(iterator(other(mTail, nullptr), mTail));
+        }
+    }
+
+    template<typename node_t>
+    typename XorList<node_t>::iterator XorList<node_t>::insert_before(iterator pos, reference node) {
+        link(pos.mFrom, node, pos.mNode);
+        return iterator(pos.mFrom, &node);
+    }
+
+    template<typename node_t>
+    typename XorList<node_t>::iterator XorList<node_t>::insert_after(iterator pos, reference node) {
+        link(pos.mNode, node, other(pos.mNode, pos.mFrom));
+        return iterator(pos.mNode, &node);
+    }
+
+    template<typename node_t>
+    typename XorList<node_t>::iterator XorList<node_t>::erase(iterator pos) {
+
+        hook_t* before = pos.mFrom;
+        hook_t* n = pos.mNode;
+
+        if (!n) {
+            return pos;
+        }
+
+        hook_t* after = other(n, before);
+
+        if (before) {
+            before->mLink ^= address(n) ^ address(after);
+        }
+        else {
+            mHead = after;
+        }
+
+        if (after) {
+            after->mLink ^= address(n) ^ address(before);
+        }
+        else {
+            mTail = before;
+        }
+
+        n->mLink = 0;
+
+        return iterator(before, after);
+    }
+
+    template<typename node_t>
+    bool XorList<node_t>::remove(reference node) {
+        for (auto it = begin(); it != end(); ++it) {
+            if (it.mNode == &node) {
+                erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename node_t>
+    bool XorList<node_t>::contains(const_reference node) const {
+        for (auto it = begin(); it != end(); ++it) {
+            if (&*it == &node) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename node_t>
+    void XorList<node_t>::splice(iterator pos, XorList& other) {
+
+        if (&other == this || other.empty()) {
+            return;
+        }
+
+        hook_t* before = pos.mFrom;
+        hook_t* after = pos.mNode;
+        hook_t* first = other.mHead;
+        hook_t* last = other.mTail;
+
+        // the ends of "other" had null outer neighbours
+        first->mLink ^= address(before);
+        last->mLink ^= address(after);
+
+        if (before) {
+            before->mLink ^= address(after) ^ address(first);
+        }
+        else {
+            mHead = first;
+        }
+
+        if (after) {
+            after->mLink ^= address(before) ^ address(last);
+        }
+        else {
+            mTail = last;
+        }
+
+        other.mHead = other.mTail = nullptr;
+    }
+
+    template<typename node_t>
+    void XorList<node_t>::reverse() {
+        hook_t* h = mHead;
+        mHead = mTail;
+        mTail = h;
+    }
+
+    template<typename node_t>
+    void XorList<node_t>::link(hook_t* before, hook_t& node, hook_t* after) {
+
+        node.mLink = address(before) ^ address(after);
+
+        if (before) {
+            before->mLink ^= address(after) ^ address(&node);
+        }
+        else {
+            mHead = &node;
+        }
+
+        if (after) {
+            after->mLink ^= address(before) ^ address(&node);
+        }
+        else {
+            mTail = &node;
+        }
+    }
+
+}
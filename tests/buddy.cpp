@@ -0,0 +1,88 @@
+#include "doctest.h"
+
+#include "ulink_buddy.hpp"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+TEST_CASE("buddy_split_and_merge") {
+    // room for 16 blocks of 256 bytes plus their metadata
+    alignas(4096) static unsigned char region[4096 + 16];
+    ulink::BuddyAllocator<8, 12> buddy(region, sizeof(region));
+
+    auto s = buddy.stats();
+    CHECK(s.total == 4096);
+    CHECK(s.free == 4096);
+    CHECK(s.largest_free == 4096);
+    CHECK(s.free_blocks == 1);
+    CHECK(s.fragmentation() == 0.0);
+
+    void* a = buddy.allocate(200);
+    REQUIRE(a != nullptr);
+    CHECK(a == region);
+    CHECK(buddy.usable_size(a) == 256);
+
+    s = buddy.stats();
+    CHECK(s.free == 4096 - 256);
+    CHECK(s.free_blocks == 4); // 256 + 512 + 1024 + 2048
+    CHECK(s.largest_free == 2048);
+    CHECK(s.fragmentation() > 0.0);
+
+    void* b = buddy.allocate(1000);
+    REQUIRE(b != nullptr);
+    CHECK(reinterpret_cast<std::uintptr_t>(b) % 1024 == 0);
+
+    CHECK(buddy.allocate(4096) == nullptr);
+    CHECK(buddy.allocate(0) == nullptr);
+
+    buddy.deallocate(a);
+    buddy.deallocate(b);
+
+    s = buddy.stats();
+    CHECK(s.free == 4096);
+    CHECK(s.free_blocks == 1);
+
+    CHECK(buddy.allocate(4096) == region);
+}
+
+TEST_CASE("buddy_random_pattern") {
+    alignas(64) static unsigned char region[100000];
+    ulink::BuddyAllocator<6, 14> buddy(region, sizeof(region));
+
+    const auto initial = buddy.stats();
+    CHECK(initial.total > 90000);
+
+    struct Allocation { unsigned char* ptr; std::size_t size; unsigned char tag; };
+    std::vector<Allocation> live;
+    std::mt19937 rng(5);
+
+    for (int step = 0; step < 20000; step++) {
+        if (live.empty() || rng() % 2) {
+            const std::size_t size = 1 + rng() % 3000;
+            auto* p = static_cast<unsigned char*>(buddy.allocate(size));
+            if (p) {
+                CHECK(buddy.usable_size(p) >= size);
+                const auto tag = static_cast<unsigned char>(step);
+                std::memset(p, tag, size);
+                live.push_back({ p, size, tag });
+            }
+        }
+        else {
+            const std::size_t i = rng() % live.size();
+            auto a = live[i];
+            bool intact = true;
+            for (std::size_t j = 0; j < a.size; j++) intact = intact && (a.ptr[j] == a.tag);
+            CHECK(intact);
+            buddy.deallocate(a.ptr);
+            live[i] = live.back();
+            live.pop_back();
+        }
+    }
+
+    for (auto& a : live) buddy.deallocate(a.ptr);
+
+    const auto s = buddy.stats();
+    CHECK(s.free == initial.free);
+    CHECK(s.free_blocks == initial.free_blocks);
+}
@@ -0,0 +1,157 @@
+#include "doctest.h"
+
+#include "ulink_buffer.hpp"
+
+#include <cstring>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    std::string flatten(const ulink::BufferChain& chain) {
+        std::string out(chain.length(), '\0');
+        chain.copy_to(&out[0], out.size());
+        return out;
+    }
+
+}
+
+TEST_CASE("buffer_chain_append_prepend_concat") {
+    char h[] = "HEAD:";
+    char b[] = "body";
+    char t[] = ":tail";
+
+    ulink::Segment head(h, 5);
+    ulink::Segment body(b, 4);
+    ulink::Segment tail(t, 5);
+
+    ulink::BufferChain chain;
+    CHECK(chain.empty());
+    chain.append(body);
+    chain.prepend(head);
+
+    ulink::BufferChain trailer;
+    trailer.append(tail);
+
+    chain.concat(trailer);
+    CHECK(trailer.empty());
+    CHECK(chain.segments() == 3);
+    CHECK(chain.length() == 14);
+    CHECK(flatten(chain) == "HEAD:body:tail");
+}
+
+TEST_CASE("buffer_chain_split") {
+    char a[] = "abcdef";
+    char b[] = "ghij";
+
+    ulink::Segment sa(a, 6);
+    ulink::Segment sb(b, 4);
+    ulink::Segment spare;
+
+    ulink::BufferChain chain;
+    chain.append(sa);
+    chain.append(sb);
+
+    // on a segment boundary the spare is not needed
+    ulink::BufferChain rest;
+    CHECK(!chain.split(6, rest, spare));
+    CHECK(flatten(chain) == "abcdef");
+    CHECK(flatten(rest) == "ghij");
+    chain.concat(rest);
+
+    // inside a segment the spare takes the second half and shares the storage
+    CHECK(chain.split(2, rest, spare));
+    CHECK(flatten(chain) == "ab");
+    CHECK(flatten(rest) == "cdefghij");
+    CHECK(&spare.owner() == &sa);
+    CHECK(sa.refcount() == 2);
+    CHECK(spare.refcount() == 2);
+
+    CHECK(!spare.release());
+    CHECK(sa.release());
+
+    // past the end nothing moves
+    ulink::BufferChain none;
+    CHECK(!rest.split(100, none, spare));
+    CHECK(none.empty());
+}
+
+TEST_CASE("buffer_chain_iovec") {
+    char a[] = "hello ";
+    char b[] = "world";
+    ulink::Segment sa(a, 6);
+    ulink::Segment sb(b, 5);
+
+    ulink::BufferChain chain;
+    chain.append(sa);
+    chain.append(sb);
+
+    struct Vec { void* iov_base; std::size_t iov_len; } vec[4];
+    CHECK(chain.to_iovec(vec, 4) == 2);
+    CHECK(vec[0].iov_base == a);
+    CHECK(vec[1].iov_len == 5);
+    CHECK(chain.to_iovec(vec, 1) == 1);
+
+#if defined(__unix__) || defined(__APPLE__)
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    iovec iov[4];
+    const auto n = chain.to_iovec(iov, 4);
+    CHECK(writev(fds[1], iov, static_cast<int>(n)) == 11);
+    char out[16] = {};
+    CHECK(read(fds[0], out, sizeof(out)) == 11);
+    CHECK(std::string(out) == "hello world");
+    close(fds[0]);
+    close(fds[1]);
+#endif
+}
+
+TEST_CASE("buffer_segment_reshare") {
+    char a[] = "abcd";
+    char b[] = "efgh";
+    ulink::Segment sa(a, 4);
+    ulink::Segment sb(b, 4);
+    ulink::Segment spare;
+
+    spare.share(sa);
+    CHECK(sa.refcount() == 2);
+
+    // sharing again drops the reference on the previous storage
+    spare.share(sb);
+    CHECK(sa.refcount() == 1);
+    CHECK(sb.refcount() == 2);
+    CHECK(&spare.owner() == &sb);
+
+    // sharing the same storage twice takes a single reference
+    spare.share(sb);
+    CHECK(sb.refcount() == 2);
+
+    CHECK(!spare.release());
+    CHECK(&spare.owner() == &spare);
+    CHECK(sb.refcount() == 1);
+    CHECK(sa.release());
+    CHECK(sb.release());
+}
+
+TEST_CASE("buffer_chain_partial_copy") {
+    char a[] = "abc";
+    char b[] = "defg";
+    ulink::Segment sa(a, 3);
+    ulink::Segment sb(b, 4);
+    ulink::Segment empty;
+
+    ulink::BufferChain chain;
+    chain.append(sa);
+    chain.append(empty);
+    chain.append(sb);
+
+    char out[8] = {};
+    CHECK(chain.copy_to(out, 5) == 5);
+    CHECK(std::string(out) == "abcde");
+    CHECK(chain.copy_to(out, sizeof(out)) == 7);
+    CHECK(std::memcmp(out, "abcdefg", 7) == 0);
+}
@@ -0,0 +1,144 @@
+#include "doctest.h"
+
+#if defined(__cpp_impl_coroutine)
+
+#include "ulink_coro.hpp"
+
+#include <coroutine>
+#include <optional>
+#include <vector>
+
+namespace {
+
+    // eager coroutine owning its frame
+    struct Task {
+        struct promise_type {
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() {}
+        };
+
+        explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+        Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+        ~Task() { if (handle) handle.destroy(); }
+
+        bool done() const { return handle.done(); }
+
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    Task waitEvent(ulink::AsyncEvent& e, int& counter) {
+        co_await e;
+        counter++;
+    }
+
+    Task produce(ulink::Channel<int>& ch, int first, int count, std::vector<bool>& results) {
+        for (int i = first; i < first + count; i++) {
+            results.push_back(co_await ch.send(i));
+        }
+    }
+
+    template<std::size_t n>
+    Task consume(ulink::Channel<int, n>& ch, std::vector<int>& out) {
+        while (auto v = co_await ch.receive()) {
+            out.push_back(*v);
+        }
+    }
+
+}
+
+TEST_CASE("coro_event_resumes_waiters") {
+    ulink::AsyncEvent e;
+    int counter = 0;
+
+    Task a = waitEvent(e, counter);
+    Task b = waitEvent(e, counter);
+    CHECK(!a.done());
+    CHECK(e.has_waiters());
+
+    e.set();
+    CHECK(counter == 2);
+    CHECK(a.done());
+    CHECK(b.done());
+    CHECK(!e.has_waiters());
+
+    // already set : no suspension
+    Task c = waitEvent(e, counter);
+    CHECK(c.done());
+    CHECK(counter == 3);
+}
+
+TEST_CASE("coro_destroyed_frame_leaves_waiter_list") {
+    ulink::AsyncEvent e;
+    int counter = 0;
+
+    Task a = waitEvent(e, counter);
+    {
+        Task b = waitEvent(e, counter);
+    }
+    CHECK(e.has_waiters());
+
+    Task c = std::move(a);
+    c.handle.destroy();
+    c.handle = {};
+    CHECK(!e.has_waiters());
+
+    e.set();
+    CHECK(counter == 0);
+}
+
+TEST_CASE("coro_rendezvous_channel") {
+    ulink::Channel<int> ch;
+    std::vector<int> received;
+    std::vector<bool> sent;
+
+    Task p = produce(ch, 0, 3, sent);
+    CHECK(!p.done());
+
+    Task c = consume(ch, received);
+    CHECK(p.done());
+    CHECK((received == std::vector<int> { 0, 1, 2 }));
+
+    Task q = produce(ch, 10, 2, sent);
+    CHECK(q.done());
+    CHECK(received.size() == 5);
+
+    ch.close();
+    CHECK(c.done());
+    CHECK(sent.size() == 5);
+    for (bool b : sent) CHECK(b);
+
+    // sending on a closed channel fails without suspending
+    Task r = produce(ch, 20, 1, sent);
+    CHECK(r.done());
+    CHECK(!sent.back());
+}
+
+TEST_CASE("coro_buffered_channel") {
+    ulink::Channel<int, 2> ch;
+    std::vector<int> received;
+
+    auto fill = [] (ulink::Channel<int, 2>& ch, int count) -> Task {
+        for (int i = 0; i < count; i++) co_await ch.send(i);
+    };
+
+    Task p = fill(ch, 5);
+    CHECK(!p.done());
+    CHECK(ch.size() == 2);
+
+    Task c = consume(ch, received);
+    CHECK(p.done());
+    CHECK((received == std::vector<int> { 0, 1, 2, 3, 4 }));
+
+    Task q = fill(ch, 1);
+    CHECK(q.done());
+    CHECK(received.size() == 6);
+
+    // buffered values are still delivered after close
+    ch.close();
+    CHECK(c.done());
+}
+
+#endif
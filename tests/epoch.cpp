@@ -0,0 +1,191 @@
+#include "doctest.h"
+
+#include "ulink_epoch.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // readers follow "next", the Node hook is free for the retire lists
+    struct Entry : ulink::Node<Entry> {
+        std::atomic<Entry*> next { nullptr };
+        std::atomic<bool> alive { true };
+        int value = 0;
+    };
+
+    std::vector<Entry*> reclaimed;
+
+    void recordReclaim(Entry& e) {
+        e.alive.store(false);
+        reclaimed.push_back(&e);
+    }
+
+}
+
+TEST_CASE("epoch_reclaims_after_readers_advance") {
+
+    reclaimed.clear();
+
+    using Domain = ulink::EpochDomain<Entry, 4>;
+
+    Domain domain(&recordReclaim, 1000);
+    Entry entries[4];
+
+    {
+        Domain::Participant writer(domain);
+        Domain::Participant reader(domain);
+
+        reader.pin();
+
+        writer.retire(entries[0]);
+        writer.retire(entries[1]);
+        CHECK(writer.pending() == 2);
+        // chained through its hook until reclaimed
+        CHECK(entries[0].isLinked());
+
+        // the reader pinned the current epoch : it moves on once, then the
+        // reader holds it back
+        CHECK(writer.collect() == 0);
+        CHECK(domain.epoch() == 1);
+        CHECK(!domain.try_advance());
+        CHECK(writer.collect() == 0);
+        CHECK(reclaimed.empty());
+
+        // re-pinning picks up the current epoch
+        reader.unpin();
+        reader.pin();
+        CHECK(writer.collect() == 2);
+        CHECK(domain.epoch() == 2);
+        CHECK(reclaimed.size() == 2);
+        CHECK(!entries[0].alive);
+        CHECK(writer.pending() == 0);
+
+        writer.retire(entries[2]);
+        reader.unpin();
+
+        {
+            Domain::Participant::Guard guard(reader);
+            CHECK(writer.collect() == 0);
+        }
+
+        writer.retire(entries[3]);
+        CHECK(writer.pending() == 2);
+    }
+
+    // a leaving participant reclaims what it retired
+    CHECK(reclaimed.size() == 4);
+    CHECK(!entries[3].alive);
+}
+
+TEST_CASE("epoch_batch_and_record_reuse") {
+
+    reclaimed.clear();
+
+    using Domain = ulink::EpochDomain<Entry, 1>;
+
+    Domain domain(&recordReclaim, 4);
+    std::vector<Entry> entries(10);
+
+    for (int round = 0; round < 2; round++) {
+        // a single record, claimed again by each participant
+        Domain::Participant p(domain);
+        for (int i = 0; i < 5; i++) {
+            p.retire(entries[round * 5 + i]);
+        }
+        // batches reclaim as retirement goes
+        CHECK(p.pending() < 5);
+    }
+
+    CHECK(reclaimed.size() == 10);
+}
+
+TEST_CASE("epoch_concurrent_readers") {
+
+    reclaimed.clear();
+
+    using Domain = ulink::EpochDomain<Entry, 8>;
+
+    constexpr int kReaders = 3;
+    constexpr int kEntries = 32;
+    constexpr int kUpdates = 20000;
+
+    Domain domain(&recordReclaim, 16);
+
+    std::vector<Entry> entries(kEntries);
+    std::atomic<Entry*> head { nullptr };
+
+    // the writer owns the nodes that are neither linked nor retired
+    std::vector<Entry*> spare;
+    for (int i = 1; i < kEntries; i++) {
+        spare.push_back(&entries[i]);
+    }
+    head.store(&entries[0]);
+
+    std::atomic<bool> done { false };
+    std::atomic<int> violations { 0 };
+    std::atomic<long> visits { 0 };
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < kReaders; r++) {
+        readers.emplace_back([&] {
+            Domain::Participant self(domain);
+            while (!done.load()) {
+                Domain::Participant::Guard guard(self);
+                for (Entry* e = head.load(); e; e = e->next.load()) {
+                    if (!e->alive.load()) {
+                        violations++;
+                    }
+                    visits++;
+                    // gives the writer a chance to unlink the current node,
+                    // which must stay alive while pinned
+                    std::this_thread::yield();
+                    if (!e->alive.load()) {
+                        violations++;
+                    }
+                }
+            }
+        });
+    }
+
+    {
+        Domain::Participant writer(domain);
+
+        while (visits.load() == 0) {
+            std::this_thread::yield();
+        }
+
+        for (int i = 0; i < kUpdates; i++) {
+
+            // runs of 16 pushes then 16 pops, reclaimed nodes coming back
+            // to the writer
+            for (Entry* e : reclaimed) {
+                spare.push_back(e);
+            }
+            reclaimed.clear();
+
+            if (!spare.empty() && ((i / 16) % 2 == 0 || !head.load())) {
+                Entry* e = spare.back();
+                spare.pop_back();
+                e->value = i;
+                e->alive.store(true);
+                e->next.store(head.load());
+                head.store(e);
+            }
+            else if (Entry* e = head.load()) {
+                head.store(e->next.load());
+                writer.retire(*e);
+            }
+        }
+
+        done.store(true);
+
+        for (auto& t : readers) {
+            t.join();
+        }
+    }
+
+    CHECK(violations.load() == 0);
+    CHECK(visits.load() > 0);
+}
@@ -0,0 +1,63 @@
+#include "doctest.h"
+
+#include "ulink_gather.hpp"
+
+struct Sample : ulink::Node<Sample> {
+    float price = 0;
+    int quantity = 0;
+    int id = 0;
+};
+
+TEST_CASE("gather_scatter_columns") {
+    ulink::List<Sample> list;
+    Sample s[5];
+    for (int i = 0; i < 5; i++) {
+        s[i].price = 1.5f * static_cast<float>(i);
+        s[i].quantity = 10 * i;
+        s[i].id = i;
+        list.push_back(s[i]);
+    }
+
+    float prices[8] = {};
+    int quantities[8] = {};
+
+    auto n = ulink::gather(
+        list,
+        8,
+        ulink::column(prices, &Sample::price),
+        ulink::column(quantities, &Sample::quantity)
+    );
+
+    CHECK(n == 5);
+    for (int i = 0; i < 5; i++) {
+        CHECK(prices[i] == s[i].price);
+        CHECK(quantities[i] == s[i].quantity);
+    }
+
+    for (auto& q : quantities) q += 1;
+
+    CHECK(ulink::scatter(list, n, ulink::column(quantities, &Sample::quantity)) == 5);
+    for (int i = 0; i < 5; i++) CHECK(s[i].quantity == 10 * i + 1);
+}
+
+TEST_CASE("gather_capacity_and_callable") {
+    ulink::List<Sample> list;
+    Sample s[4];
+    for (int i = 0; i < 4; i++) {
+        s[i].id = i + 1;
+        list.push_back(s[i]);
+    }
+
+    int ids[2] = {};
+    CHECK(ulink::gather(list, ids, 2, [] (const Sample& x) { return x.id * 2; }) == 2);
+    CHECK(ids[0] == 2);
+    CHECK(ids[1] == 4);
+
+    const int values[4] = { 7, 8, 9, 10 };
+    CHECK(ulink::scatter(list, values, 3, [] (Sample& x) -> int& { return x.quantity; }) == 3);
+    CHECK(s[2].quantity == 9);
+    CHECK(s[3].quantity == 0);
+
+    ulink::List<Sample> empty;
+    CHECK(ulink::gather(empty, ids, 2, &Sample::id) == 0);
+}
@@ -0,0 +1,137 @@
+#include "doctest.h"
+
+#include "ulink_indexed.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+struct Row : ulink::IndexedNode<Row, 4> {
+    int id = 0;
+};
+
+namespace {
+
+    void checkAgainst(ulink::IndexedList<Row>& list, const std::vector<Row*>& ref) {
+        REQUIRE(list.size() == ref.size());
+        for (std::size_t k = 0; k < ref.size(); k++) {
+            CHECK(&(*list.nth(k)) == ref[k]);
+            CHECK(list.index_of(*ref[k]) == k);
+        }
+        CHECK(list.nth(ref.size()) == list.end());
+    }
+
+}
+
+TEST_CASE("indexed_push_and_nth") {
+    ulink::IndexedList<Row> list;
+
+    CHECK(list.empty());
+    CHECK(list.size() == 0);
+    CHECK(list.nth(0) == list.end());
+
+    std::vector<Row> rows(300);
+    std::vector<Row*> ref;
+
+    for (std::size_t i = 0; i < rows.size(); i++) {
+        rows[i].id = static_cast<int>(i);
+        if (i % 2) {
+            list.push_back(rows[i]);
+            ref.push_back(&rows[i]);
+        }
+        else {
+            list.push_front(rows[i]);
+            ref.insert(ref.begin(), &rows[i]);
+        }
+    }
+
+    checkAgainst(list, ref);
+
+    int i = 0;
+    for (auto& r : list) CHECK(&r == ref[i++]);
+}
+
+TEST_CASE("indexed_random_insert_erase") {
+    ulink::IndexedList<Row> list;
+    std::vector<Row> rows(500);
+    std::vector<Row*> ref;
+    std::mt19937 rng(7);
+
+    for (int step = 0; step < 3000; step++) {
+        Row& r = rows[rng() % rows.size()];
+
+        if (r.isLinked()) {
+            ref.erase(std::find(ref.begin(), ref.end(), &r));
+            if (rng() % 2) {
+                r.remove();
+            }
+            else {
+                list.erase(ulink::IndexedList<Row>::iterator(&r));
+            }
+        }
+        else {
+            const std::size_t k = ref.empty() ? 0 : rng() % (ref.size() + 1);
+            if (k < ref.size() && rng() % 2) {
+                list.insert_after(list.nth(k), r);
+                ref.insert(ref.begin() + static_cast<long>(k) + 1, &r);
+            }
+            else {
+                list.insert_before(list.nth(k), r);
+                ref.insert(ref.begin() + static_cast<long>(k), &r);
+            }
+        }
+
+        if (step % 250 == 0) {
+            checkAgainst(list, ref);
+        }
+    }
+
+    checkAgainst(list, ref);
+
+    {
+        Row temp;
+        list.insert_before(list.nth(3), temp);
+        CHECK(list.index_of(temp) == 3);
+        CHECK(list.size() == ref.size() + 1);
+    }
+
+    checkAgainst(list, ref);
+
+    list.clear();
+    CHECK(list.empty());
+    CHECK(list.size() == 0);
+}
+
+TEST_CASE("indexed_clear_large") {
+
+    // clear and destruction must stay linear, 200k nodes took minutes
+    // while they were quadratic
+    constexpr std::size_t count = 200000;
+    std::vector<Row> rows(count);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    {
+        ulink::IndexedList<Row> list;
+        for (auto& r : rows) {
+            list.push_back(r);
+        }
+        list.clear();
+        CHECK(list.empty());
+        CHECK(!rows.front().isLinked());
+        CHECK(!rows.back().isLinked());
+
+        // the list is usable again after clear, the destructor clears it
+        for (auto& r : rows) {
+            list.push_back(r);
+        }
+        CHECK(list.size() == count);
+        CHECK(&(*list.nth(count / 2)) == &rows[count / 2]);
+    }
+
+    CHECK(!rows[count / 2].isLinked());
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    CHECK(elapsed < std::chrono::seconds(2));
+}
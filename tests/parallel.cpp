@@ -0,0 +1,85 @@
+#include "doctest.h"
+
+#include "ulink_parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+struct Job : ulink::Node<Job> {
+    std::atomic<int> visits { 0 };
+    long value = 0;
+    std::size_t rank = 0;
+};
+
+TEST_CASE("parallel_for_each_visits_once") {
+    const std::size_t sizes[] = { 0, 1, 5, 1000, 12345 };
+    const std::size_t threadCounts[] = { 1, 2, 3, 7 };
+
+    for (auto size : sizes) {
+        for (auto threads : threadCounts) {
+            std::vector<Job> jobs(size);
+            ulink::List<Job> list;
+            for (std::size_t i = 0; i < size; i++) {
+                jobs[i].value = static_cast<long>(i);
+                list.push_back(jobs[i]);
+            }
+
+            std::atomic<long> sum { 0 };
+            ulink::parallel_for_each(list, [&sum] (Job& j) {
+                j.visits++;
+                sum += j.value;
+            }, threads);
+
+            const long n = static_cast<long>(size);
+            CHECK(sum == n * (n - 1) / 2);
+            for (auto& j : jobs) CHECK(j.visits == 1);
+            CHECK(list.size() == size);
+        }
+    }
+}
+
+TEST_CASE("parallel_sort_is_stable") {
+    constexpr std::size_t kCount = 50000;
+
+    std::vector<Job> jobs(kCount);
+    for (std::size_t i = 0; i < kCount; i++) {
+        jobs[i].value = static_cast<long>((i * 7919) % 1000);
+    }
+
+    std::vector<Job*> order(kCount);
+    for (std::size_t i = 0; i < kCount; i++) {
+        order[i] = &jobs[i];
+    }
+
+    std::mt19937 rng(1234);
+
+    const std::size_t threadCounts[] = { 1, 2, 3, 4 };
+
+    for (auto threads : threadCounts) {
+
+        // a new permutation every round, "rank" being the input position
+        std::shuffle(order.begin(), order.end(), rng);
+        ulink::List<Job> list;
+        for (std::size_t i = 0; i < kCount; i++) {
+            order[i]->rank = i;
+            list.push_back(*order[i]);
+        }
+
+        ulink::parallel_sort(list, [] (const Job& a, const Job& b) { return a.value < b.value; }, threads);
+
+        CHECK(list.size() == kCount);
+
+        // equal values must keep their input order
+        bool sorted = true;
+        const Job* prev = nullptr;
+        for (auto& j : list) {
+            if (prev && (prev->value > j.value || (prev->value == j.value && prev->rank > j.rank))) {
+                sorted = false;
+            }
+            prev = &j;
+        }
+        CHECK(sorted);
+    }
+}
@@ -0,0 +1,120 @@
+#include "doctest.h"
+
+#include "ulink_pool.hpp"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Buffer : ulink::Node<Buffer> {
+    int owner = -1;
+};
+
+TEST_CASE("pool_acquire_release") {
+    static ulink::ObjectPool<Buffer, 4> pool;
+
+    CHECK(pool.capacity() == 4);
+    CHECK(pool.available() == 4);
+
+    Buffer* b[4];
+    for (auto& p : b) {
+        p = pool.acquire();
+        REQUIRE(p != nullptr);
+        CHECK(pool.owns(*p));
+    }
+
+    CHECK(pool.available() == 0);
+    CHECK(pool.acquire() == nullptr);
+
+    // an acquired object can be linked in user lists
+    ulink::List<Buffer> inUse;
+    for (auto* p : b) inUse.push_back(*p);
+    CHECK(inUse.size() == 4);
+
+    // releasing unlinks it from the user list
+    pool.release(*b[1]);
+    CHECK(inUse.size() == 3);
+    CHECK(pool.available() == 1);
+    CHECK(pool.acquire() == b[1]);
+
+    Buffer outsider;
+    CHECK(!pool.owns(outsider));
+
+    for (auto* p : b) pool.release(*p);
+    CHECK(pool.available() == 4);
+    CHECK(inUse.empty());
+}
+
+TEST_CASE("pool_batch_transfer") {
+    static ulink::ObjectPool<Buffer, 10> pool;
+    ulink::List<Buffer> batch;
+
+    CHECK(pool.acquire(batch, 4) == 4);
+    CHECK(batch.size() == 4);
+    CHECK(pool.available() == 6);
+
+    CHECK(pool.acquire(batch, 20) == 6);
+    CHECK(pool.available() == 0);
+
+    pool.release(batch);
+    CHECK(batch.empty());
+    CHECK(pool.available() == 10);
+}
+
+TEST_CASE("pool_thread_caches") {
+    static ulink::ObjectPool<Buffer, 256, std::mutex> pool;
+
+    constexpr int kThreads = 4;
+    std::vector<std::thread> threads;
+    bool ok[kThreads] = {};
+
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([t, &ok] {
+            ulink::PoolCache<decltype(pool), 8> cache(pool);
+            ulink::List<Buffer> held;
+            bool good = true;
+            for (int round = 0; round < 200; round++) {
+                for (int i = 0; i < 40; i++) {
+                    auto* b = cache.acquire();
+                    if (!b) { good = false; break; }
+                    b->owner = t;
+                    held.push_back(*b);
+                }
+                for (auto& b : held) good = good && (b.owner == t);
+                while (!held.empty()) {
+                    auto& b = held.front();
+                    cache.release(b);
+                }
+                good = good && cache.cached() < 16;
+            }
+            ok[t] = good;
+        });
+    }
+
+    for (auto& th : threads) th.join();
+    for (bool b : ok) CHECK(b);
+    CHECK(pool.available() == 256);
+}
+
+TEST_CASE("pool_cache_double_release") {
+    static ulink::ObjectPool<Buffer, 8> pool;
+
+    {
+        ulink::PoolCache<decltype(pool), 2> cache(pool);
+
+        auto* a = cache.acquire();
+        REQUIRE(a != nullptr);
+        CHECK(cache.cached() == 1);
+
+        cache.release(*a);
+        cache.release(*a);
+        CHECK(cache.cached() == 2);
+
+        // the cached count still matches what the cache can hand out
+        CHECK(cache.acquire() != nullptr);
+        CHECK(cache.acquire() != nullptr);
+        CHECK(cache.cached() == 0);
+    }
+
+    CHECK(pool.available() == 6);
+}
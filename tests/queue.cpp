@@ -0,0 +1,186 @@
+#include "doctest.h"
+
+#include "ulink.hpp"
+#include "ulink_queue.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    struct Job : ulink::QueueNode<Job>, ulink::Node<Job> {
+        int id = 0;
+        std::atomic<int> pops { 0 };
+    };
+
+    template<typename queue_t>
+    void checkFifo(queue_t& q) {
+
+        Job jobs[4];
+        for (int i = 0; i < 4; i++) {
+            jobs[i].id = i;
+        }
+
+        CHECK(q.pop() == nullptr);
+
+        q.push(jobs[0]);
+        CHECK(q.pop() == &jobs[0]);
+        CHECK(q.pop() == nullptr);
+
+        // popped nodes are reusable right away
+        q.push(jobs[0]);
+        q.push(jobs[1]);
+        q.push(jobs[2]);
+        CHECK(q.pop() == &jobs[0]);
+        q.push(jobs[3]);
+        q.push(jobs[0]);
+        CHECK(q.pop() == &jobs[1]);
+        CHECK(q.pop() == &jobs[2]);
+        CHECK(q.pop() == &jobs[3]);
+        CHECK(q.pop() == &jobs[0]);
+        CHECK(q.pop() == nullptr);
+        CHECK(q.pop() == nullptr);
+    }
+
+}
+
+TEST_CASE("mpmc_queue_fifo") {
+    ulink::MpmcQueue<Job> q;
+    CHECK(q.empty());
+    checkFifo(q);
+    CHECK(q.empty());
+
+    // a popped node may join a List through its other hook
+    Job a, b;
+    q.push(a);
+    q.push(b);
+    ulink::List<Job> list;
+    while (Job* j = q.pop()) {
+        list.push_back(*j);
+    }
+    CHECK(list.size() == 2);
+    CHECK(&list.front() == &a);
+}
+
+TEST_CASE("mpsc_queue_fifo") {
+    ulink::MpscQueue<Job> q;
+    checkFifo(q);
+}
+
+TEST_CASE("mpmc_queue_concurrent_recycling") {
+
+    // producers take nodes from a free queue and consumers give them back,
+    // so every node is popped and pushed again while other threads may
+    // still be reading it
+    constexpr int kProducers = 3;
+    constexpr int kConsumers = 3;
+    constexpr int kPerProducer = 20000;
+    constexpr int kJobs = 64;
+
+    // 2 slots for 6 threads : claiming waits for a slot
+    ulink::MpmcQueue<Job, 2> work;
+    ulink::MpmcQueue<Job> spare;
+
+    std::vector<Job> jobs(kJobs);
+    for (auto& j : jobs) {
+        spare.push(j);
+    }
+
+    std::atomic<int> consumed { 0 };
+    std::atomic<long long> sum { 0 };
+
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < kProducers; p++) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; i++) {
+                Job* j;
+                while (!(j = spare.pop())) {
+                    std::this_thread::yield();
+                }
+                j->id = p * kPerProducer + i;
+                work.push(*j);
+            }
+        });
+    }
+
+    for (int c = 0; c < kConsumers; c++) {
+        threads.emplace_back([&] {
+            while (consumed.load() < kProducers * kPerProducer) {
+                if (Job* j = work.pop()) {
+                    sum += j->id;
+                    j->pops++;
+                    consumed++;
+                    spare.push(*j);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    constexpr long long total = kProducers * kPerProducer;
+    CHECK(consumed.load() == total);
+    CHECK(sum.load() == total * (total - 1) / 2);
+    CHECK(work.pop() == nullptr);
+
+    int pops = 0;
+    int freed = 0;
+    for (auto& j : jobs) {
+        pops += j.pops.load();
+    }
+    while (spare.pop()) {
+        freed++;
+    }
+    CHECK(pops == total);
+    CHECK(freed == kJobs);
+}
+
+TEST_CASE("mpsc_queue_concurrent") {
+
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 10000;
+
+    ulink::MpscQueue<Job> q;
+    std::vector<Job> jobs(kProducers * kPerProducer);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; p++) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; i++) {
+                Job& j = jobs[p * kPerProducer + i];
+                j.id = i;
+                q.push(j);
+            }
+        });
+    }
+
+    // per producer order is kept
+    int last[kProducers] = { -1, -1, -1, -1 };
+    int received = 0;
+    bool ordered = true;
+    while (received < kProducers * kPerProducer) {
+        if (Job* j = q.pop()) {
+            const auto p = (j - jobs.data()) / kPerProducer;
+            ordered = ordered && (j->id == last[p] + 1);
+            last[p] = j->id;
+            received++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    CHECK(ordered);
+    CHECK(q.pop() == nullptr);
+}
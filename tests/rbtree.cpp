@@ -0,0 +1,228 @@
+#include "doctest.h"
+
+#include "ulink_rbtree.hpp"
+
+#include <random>
+#include <vector>
+
+struct Order : ulink::RbNode<Order> {
+    Order(int p = 0) : price(p) {}
+    int price;
+};
+
+struct ByPrice {
+    bool operator()(const Order& a, const Order& b) const { return a.price < b.price; }
+    bool operator()(const Order& a, int p) const { return a.price < p; }
+    bool operator()(int p, const Order& b) const { return p < b.price; }
+};
+
+// reads the protected links through member pointers to check the invariants
+struct RbProbe : ulink::RbNode<Order> {
+
+    using hook_t = ulink::RbNode<Order>;
+
+    // returns the black height of the subtree, or -1 on a violation
+    static int blackHeight(const hook_t* n, const hook_t* parent) {
+        if (!n) {
+            return 1;
+        }
+        if (n->*(&RbProbe::parent) != parent) {
+            return -1;
+        }
+        const bool red = (n->*(&RbProbe::color) == Color::Red);
+        const hook_t* l = n->*(&RbProbe::left);
+        const hook_t* r = n->*(&RbProbe::right);
+        if (red && (isRed(l) || isRed(r))) {
+            return -1;
+        }
+        const int lh = blackHeight(l, n);
+        const int rh = blackHeight(r, n);
+        if (lh < 0 || lh != rh) {
+            return -1;
+        }
+        return lh + (red ? 0 : 1);
+    }
+
+    static bool valid(ulink::RbTree<Order, ByPrice>& tree) {
+        if (tree.empty()) {
+            return true;
+        }
+        const hook_t* header = &static_cast<hook_t&>(tree.front());
+        while (header->*(&RbProbe::color) != Color::Header) {
+            header = header->*(&RbProbe::parent);
+        }
+        const hook_t* root = header->*(&RbProbe::parent);
+        return !isRed(root) && blackHeight(root, header) > 0;
+    }
+};
+
+TEST_CASE("rbtree_insert_in_order") {
+    ulink::RbTree<Order, ByPrice> tree;
+
+    CHECK(tree.empty());
+    CHECK(tree.size() == 0);
+    CHECK(tree.begin() == tree.end());
+
+    std::vector<Order> orders(257);
+    for (std::size_t i = 0; i < orders.size(); i++) {
+        orders[i].price = static_cast<int>((i * 97) % orders.size());
+        tree.insert(orders[i]);
+    }
+
+    CHECK(tree.size() == orders.size());
+    CHECK(tree.front().price == 0);
+    CHECK(tree.back().price == 256);
+
+    int expected = 0;
+    for (auto& o : tree) CHECK(o.price == expected++);
+
+    expected = 256;
+    for (auto it = tree.rbegin(); it != tree.rend(); ++it) CHECK((*it).price == expected--);
+
+    auto it = tree.end();
+    --it;
+    CHECK(it->price == 256);
+}
+
+TEST_CASE("rbtree_bounds") {
+    ulink::RbTree<Order, ByPrice> tree;
+    Order a(10); Order b(20); Order c(20); Order d(20); Order e(30);
+
+    tree.insert(e);
+    tree.insert(c);
+    tree.insert(a);
+    tree.insert(b);
+    tree.insert(d);
+
+    CHECK(tree.lower_bound(20)->price == 20);
+    CHECK(&(*tree.lower_bound(20)) == &c);
+    CHECK(tree.upper_bound(20)->price == 30);
+    CHECK(tree.lower_bound(31) == tree.end());
+    CHECK(tree.upper_bound(5)->price == 10);
+
+    auto range = tree.equal_range(20);
+    const Order* expected[] = { &c, &b, &d };
+    int i = 0;
+    for (auto it = range.first; it != range.second; ++it) CHECK(&(*it) == expected[i++]);
+    CHECK(i == 3);
+
+    CHECK(tree.find(30) != tree.end());
+    CHECK(tree.find(25) == tree.end());
+
+    const auto& ctree = tree;
+    CHECK(ctree.find(10)->price == 10);
+    CHECK(ctree.lower_bound(11)->price == 20);
+}
+
+TEST_CASE("rbtree_erase_and_auto_unlink") {
+    ulink::RbTree<Order, ByPrice> tree;
+
+    std::vector<Order> orders(100);
+    for (std::size_t i = 0; i < orders.size(); i++) {
+        orders[i].price = static_cast<int>(i);
+        tree.insert(orders[i]);
+    }
+
+    // erase every even price through iterators
+    for (auto it = tree.begin(); it != tree.end();) {
+        it = (it->price % 2 == 0) ? tree.erase(it) : ++it;
+    }
+
+    CHECK(tree.size() == 50);
+    CHECK(!orders[0].isLinked());
+    CHECK(orders[1].isLinked());
+
+    int expected = 1;
+    for (auto& o : tree) {
+        CHECK(o.price == expected);
+        expected += 2;
+    }
+
+    // direct removal from the node
+    orders[51].remove();
+    CHECK(tree.find(51) == tree.end());
+    CHECK(tree.size() == 49);
+
+    {
+        Order temp(42);
+        tree.insert(temp);
+        CHECK(tree.size() == 50);
+        CHECK(tree.find(42) != tree.end());
+    }
+
+    CHECK(tree.size() == 49);
+    CHECK(tree.find(42) == tree.end());
+
+    tree.clear();
+    CHECK(tree.empty());
+    CHECK(!orders[1].isLinked());
+}
+
+TEST_CASE("rbtree_reinsert_moves_node") {
+    ulink::RbTree<Order, ByPrice> tree;
+    Order a(1); Order b(2); Order c(3);
+    tree.insert(a);
+    tree.insert(b);
+    tree.insert(c);
+
+    a.price = 4;
+    tree.insert(a);
+
+    CHECK(tree.size() == 3);
+    CHECK(tree.front().price == 2);
+    CHECK(tree.back().price == 4);
+}
+
+TEST_CASE("rbtree_const_iterator_conversion") {
+    ulink::RbTree<Order, ByPrice> tree;
+    Order a(1); Order b(2);
+    tree.insert(a);
+    tree.insert(b);
+
+    ulink::RbTree<Order, ByPrice>::const_iterator it = tree.begin();
+    CHECK(it->price == 1);
+    ++it;
+    CHECK((*it).price == 2);
+
+    ulink::RbTree<Order, ByPrice>::const_reverse_iterator rit = tree.rbegin();
+    CHECK(rit->price == 2);
+}
+
+TEST_CASE("rbtree_random_keeps_invariants") {
+    ulink::RbTree<Order, ByPrice> tree;
+    std::vector<Order> orders(512);
+    std::mt19937 rng(7);
+
+    for (int round = 0; round < 4000; round++) {
+        auto& o = orders[rng() % orders.size()];
+        if (o.isLinked() && (rng() % 2)) {
+            o.remove();
+        }
+        else {
+            o.price = static_cast<int>(rng() % 64);
+            tree.insert(o);
+        }
+        if (round % 16 == 0) {
+            REQUIRE(RbProbe::valid(tree));
+        }
+    }
+
+    REQUIRE(RbProbe::valid(tree));
+
+    std::size_t linked = 0;
+    for (auto& o : orders) linked += o.isLinked() ? 1 : 0;
+    CHECK(tree.size() == linked);
+
+    int last = -1;
+    for (auto& o : tree) {
+        CHECK(last <= o.price);
+        last = o.price;
+    }
+
+    // erase through iterators until empty, validating on the way
+    for (auto it = tree.begin(); it != tree.end();) {
+        it = tree.erase(it);
+        REQUIRE(RbProbe::valid(tree));
+    }
+    CHECK(tree.empty());
+}
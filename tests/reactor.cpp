@@ -0,0 +1,209 @@
+#include "doctest.h"
+
+#if defined(__linux__)
+
+#include "ulink_reactor.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+    struct Counter : ulink::Reactor::Handler {
+        explicit Counter(int fd) : Handler(fd, &onEvent) {}
+
+        static void onEvent(Handler& h, std::uint32_t events) {
+            auto& self = static_cast<Counter&>(h);
+            self.calls++;
+            self.lastEvents = events;
+            if (events & EPOLLIN) {
+                std::uint64_t value;
+                if (read(h.fd(), &value, sizeof(value)) == sizeof(value)) self.total += value;
+            }
+            if (self.victim && *self.victim) {
+                delete *self.victim;
+                *self.victim = nullptr;
+            }
+        }
+
+        int calls = 0;
+        std::uint32_t lastEvents = 0;
+        std::uint64_t total = 0;
+        Counter** victim = nullptr;
+    };
+
+    void signal(int fd, std::uint64_t value) {
+        CHECK(write(fd, &value, sizeof(value)) == sizeof(value));
+    }
+
+}
+
+TEST_CASE("reactor_eventfd_dispatch") {
+    ulink::Reactor reactor;
+    REQUIRE(reactor.valid());
+
+    const int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    Counter h(fd);
+    CHECK(reactor.add(h, EPOLLIN));
+    CHECK(h.registered());
+    CHECK(reactor.handler_count() == 1);
+
+    CHECK(reactor.run_once(std::chrono::milliseconds(0)) == 0);
+
+    signal(fd, 3);
+    signal(fd, 4);
+    CHECK(reactor.run_once(std::chrono::milliseconds(100)) == 1);
+    CHECK(h.calls == 1);
+    CHECK(h.total == 7);
+
+    reactor.remove(h);
+    CHECK(!h.registered());
+    CHECK(reactor.handler_count() == 0);
+
+    signal(fd, 1);
+    CHECK(reactor.run_once(std::chrono::milliseconds(0)) == 0);
+    CHECK(h.calls == 1);
+
+    close(fd);
+}
+
+TEST_CASE("reactor_long_timeouts_are_clamped") {
+    ulink::Reactor reactor;
+    REQUIRE(reactor.valid());
+
+    const int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    Counter h(fd);
+    CHECK(reactor.add(h, EPOLLIN));
+
+    // 2^32 ms would truncate to a zero timeout and return at once, the
+    // wait must last until the event instead
+    const std::chrono::milliseconds far(std::int64_t(1) << 32);
+
+    std::thread late([fd] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        signal(fd, 1);
+    });
+    CHECK(reactor.run_once(far) == 1);
+    late.join();
+    CHECK(h.calls == 1);
+
+    // same for a timer about 49.7 days away
+    ulink::Reactor::Timer t([](ulink::Reactor::Timer&) {});
+    reactor.schedule_after(t, far + std::chrono::microseconds(500));
+
+    late = std::thread([fd] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        signal(fd, 1);
+    });
+    CHECK(reactor.run_once() == 1);
+    late.join();
+    CHECK(h.calls == 2);
+    CHECK(t.pending());
+
+    reactor.remove(h);
+    close(fd);
+}
+
+TEST_CASE("reactor_pipe_modify") {
+    ulink::Reactor reactor;
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+
+    Counter writer(fds[1]);
+    CHECK(reactor.add(writer, EPOLLOUT));
+    CHECK(reactor.run_once(std::chrono::milliseconds(100)) == 1);
+    CHECK((writer.lastEvents & EPOLLOUT) != 0);
+
+    // no longer interested in writability
+    CHECK(reactor.modify(writer, 0));
+    CHECK(reactor.run_once(std::chrono::milliseconds(0)) == 0);
+
+    Counter reader(fds[0]);
+    CHECK(reactor.add(reader, EPOLLIN));
+    CHECK(reactor.run_once(std::chrono::milliseconds(0)) == 0);
+
+    const char byte = 'x';
+    CHECK(write(fds[1], &byte, 1) == 1);
+    CHECK(reactor.run_once(std::chrono::milliseconds(100)) == 1);
+    CHECK(reader.calls == 1);
+    CHECK((reader.lastEvents & EPOLLIN) != 0);
+
+    reactor.remove(reader);
+    reactor.remove(writer);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_CASE("reactor_handler_destroyed_during_batch") {
+    ulink::Reactor reactor;
+    const int fdA = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    const int fdB = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    // whichever runs first deletes the other one
+    Counter* handlers[2] = { new Counter(fdA), new Counter(fdB) };
+    handlers[0]->victim = &handlers[1];
+    handlers[1]->victim = &handlers[0];
+
+    reactor.add(*handlers[0], EPOLLIN);
+    reactor.add(*handlers[1], EPOLLIN);
+
+    signal(fdA, 1);
+    signal(fdB, 1);
+
+    // both are ready in the same batch
+    CHECK(reactor.run_once(std::chrono::milliseconds(100)) == 1);
+    CHECK(reactor.handler_count() == 1);
+    CHECK(reactor.run_once(std::chrono::milliseconds(0)) == 0);
+
+    CHECK((handlers[0] == nullptr) != (handlers[1] == nullptr));
+    delete handlers[0];
+    delete handlers[1];
+    CHECK(reactor.handler_count() == 0);
+
+    close(fdA);
+    close(fdB);
+}
+
+TEST_CASE("reactor_timers") {
+    ulink::Reactor reactor;
+
+    struct Tick : ulink::Reactor::Timer {
+        Tick(ulink::Reactor& r) : Timer(&onTimer), reactor(r) {}
+        static void onTimer(Timer& t) {
+            auto& self = static_cast<Tick&>(t);
+            // rearmed timers wait for the next batch
+            if (++self.count < 3) self.reactor.schedule_after(self, std::chrono::milliseconds(0));
+        }
+        ulink::Reactor& reactor;
+        int count = 0;
+    };
+
+    Tick tick(reactor);
+    Tick late(reactor);
+
+    const auto now = ulink::Reactor::clock::now();
+    reactor.schedule(late, now + std::chrono::hours(1));
+    reactor.schedule(tick, now + std::chrono::milliseconds(5));
+    CHECK(reactor.timer_count() == 2);
+
+    // waits for the deadline rather than the whole timeout
+    const auto start = ulink::Reactor::clock::now();
+    CHECK(reactor.run_once(std::chrono::seconds(10)) == 1);
+    CHECK(ulink::Reactor::clock::now() - start < std::chrono::seconds(5));
+    CHECK(tick.count == 1);
+    CHECK(tick.pending());
+
+    reactor.run_once(std::chrono::milliseconds(0));
+    reactor.run_once(std::chrono::milliseconds(0));
+    CHECK(tick.count == 3);
+    CHECK(!tick.pending());
+
+    late.cancel();
+    CHECK(reactor.timer_count() == 0);
+}
+
+#endif
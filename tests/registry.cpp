@@ -0,0 +1,169 @@
+#include "doctest.h"
+
+#include "ulink_registry.hpp"
+
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    struct Command : ulink::RegistryNode<Command> {
+        Command(std::string_view name, int id);
+        std::string_view name;
+        int id;
+    };
+
+    // the entries are defined before the registry on purpose : the registry
+    // being constant-initialized, it is usable by their constructors
+    extern ulink::Registry<Command> commands;
+
+    Command helpCommand("help", 3);
+    Command listCommand("list", 1);
+    Command quitCommand("quit", 2);
+
+#if defined(__cpp_constinit)
+    constinit
+#endif
+    ulink::Registry<Command> commands;
+
+    Command::Command(std::string_view name, int id) : name(name), id(id) {
+        commands.add(*this);
+    }
+
+}
+
+TEST_CASE("registry_static_registration") {
+
+    CHECK(commands.size() == 3);
+    CHECK(!commands.empty());
+
+    // most recent first
+    const int registered[] = { 2, 1, 3 };
+    int i = 0;
+    for (auto& c : commands) {
+        CHECK(c.id == registered[i++]);
+    }
+    CHECK(i == 3);
+
+    const auto byName = [] (const Command& a, const Command& b) { return a.name < b.name; };
+
+    std::string_view names;
+    std::size_t count = 0;
+    for (auto& c : commands.sort_once(byName)) {
+        count++;
+        CHECK(names < c.name);
+        names = c.name;
+    }
+    CHECK(count == 3);
+    CHECK(commands.begin()->id == 3);
+
+    // sorted already, nothing changes
+    const auto byId = [] (const Command& a, const Command& b) { return a.id < b.id; };
+    commands.sort_once(byId);
+    CHECK(commands.begin()->id == 3);
+}
+
+TEST_CASE("registry_concurrent_add") {
+
+    struct Entry : ulink::RegistryNode<Entry> {
+        int value = 0;
+    };
+
+    constexpr int threadCount = 4;
+    constexpr int perThread = 500;
+
+    static ulink::Registry<Entry> registry;
+    static std::vector<Entry> entries(threadCount * perThread);
+
+    for (int i = 0; i < threadCount * perThread; i++) {
+        entries[i].value = i;
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back(
+            [t] () {
+                for (int i = 0; i < perThread; i++) {
+                    registry.add(entries[t * perThread + i]);
+                }
+            }
+        );
+    }
+
+    // walking while entries are added
+    std::size_t seen = 0;
+    for (const auto& e : static_cast<const ulink::Registry<Entry>&>(registry)) {
+        (void) e;
+        seen++;
+    }
+    CHECK(seen <= entries.size());
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    CHECK(registry.size() == entries.size());
+
+    int expected = 0;
+    for (auto& e : registry.sort_once([] (const Entry& a, const Entry& b) { return a.value < b.value; })) {
+        CHECK(e.value == expected++);
+    }
+    CHECK(expected == threadCount * perThread);
+
+    static Entry late;
+    late.value = -1;
+    registry.add(late);
+    CHECK(registry.begin()->value == -1);
+    registry.sort_once([] (const Entry& a, const Entry& b) { return a.value < b.value; });
+    CHECK(registry.begin()->value == -1);
+    CHECK(std::next(registry.begin())->value == 0);
+    CHECK(registry.size() == entries.size() + 1);
+}
+
+TEST_CASE("registry_add_during_sort") {
+
+    struct Entry : ulink::RegistryNode<Entry> {
+        int value = 0;
+    };
+
+    static ulink::Registry<Entry> registry;
+    static Entry entries[3];
+    static Entry extra;
+
+    const int values[] = { 3, 1, 2 };
+    for (int i = 0; i < 3; i++) {
+        entries[i].value = values[i];
+        registry.add(entries[i]);
+    }
+
+    // the comparator registers an entry while the sort is running
+    extra.value = 0;
+    bool added = false;
+    const auto byValue = [&added] (const Entry& a, const Entry& b) {
+        if (!added) {
+            added = true;
+            registry.add(extra);
+        }
+        return a.value < b.value;
+    };
+
+    registry.sort_once(byValue);
+    CHECK(registry.size() == 4);
+
+    // the late entry is linked behind the sorted run
+    const int sorted[] = { 1, 2, 3, 0 };
+    int i = 0;
+    for (auto& e : registry) {
+        CHECK(e.value == sorted[i++]);
+    }
+    CHECK(i == 4);
+
+    // and sorted by the next call
+    registry.sort_once(byValue);
+    i = 0;
+    for (auto& e : registry) {
+        CHECK(e.value == i++);
+    }
+    CHECK(i == 4);
+}
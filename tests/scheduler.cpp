@@ -0,0 +1,166 @@
+#include "doctest.h"
+
+#include "ulink_scheduler.hpp"
+
+#include <chrono>
+#include <string>
+
+namespace {
+
+    // manual tick clock
+    struct TickClock {
+        using duration = std::chrono::milliseconds;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::time_point<TickClock>;
+        static time_point now() { return time_point(duration(ticks)); }
+        static inline long long ticks = 0;
+    };
+
+    using Sched = ulink::Scheduler<8, TickClock>;
+
+    struct Recorder : Sched::Task {
+        Recorder(std::string& log, char name, std::uint8_t prio) : Sched::Task(&step, prio), log(log), name(name) {}
+        static void step(Sched::Task& t) { auto& r = static_cast<Recorder&>(t); r.log += r.name; }
+        std::string& log;
+        char name;
+    };
+
+}
+
+TEST_CASE("scheduler_priorities_and_round_robin") {
+    Sched sched;
+    std::string log;
+    Recorder a(log, 'a', 1);
+    Recorder b(log, 'b', 1);
+    Recorder h(log, 'h', 5);
+
+    CHECK(!sched.run_once());
+
+    sched.ready(a);
+    sched.ready(b);
+    sched.ready(h);
+
+    for (int i = 0; i < 3; i++) sched.run_once();
+    CHECK(log == "hhh");
+
+    sched.suspend(h);
+    CHECK(h.state() == Sched::Task::State::Idle);
+
+    for (int i = 0; i < 4; i++) sched.run_once();
+    CHECK(log == "hhhabab");
+
+    sched.set_priority(b, 2);
+    for (int i = 0; i < 2; i++) sched.run_once();
+    CHECK(log == "hhhababbb");
+    CHECK(sched.switches() == 9);
+}
+
+TEST_CASE("scheduler_sleep_list") {
+    Sched sched;
+    std::string log;
+    Recorder a(log, 'a', 0);
+    Recorder b(log, 'b', 0);
+    Recorder c(log, 'c', 0);
+
+    TickClock::ticks = 0;
+    sched.sleep_for(a, std::chrono::milliseconds(30));
+    sched.sleep_for(b, std::chrono::milliseconds(10));
+    sched.sleep_for(c, std::chrono::milliseconds(20));
+
+    CHECK(a.state() == Sched::Task::State::Sleeping);
+    CHECK(sched.next_wake_time() == TickClock::time_point(std::chrono::milliseconds(10)));
+    CHECK(!sched.run_once());
+
+    TickClock::ticks = 25;
+    sched.run_once();
+    sched.run_once();
+    CHECK(log == "bc");
+    CHECK(a.state() == Sched::Task::State::Sleeping);
+
+    // a destroyed sleeper simply leaves the list
+    {
+        Recorder d(log, 'd', 0);
+        sched.sleep_for(d, std::chrono::milliseconds(1));
+    }
+    CHECK(sched.next_wake_time() == TickClock::time_point(std::chrono::milliseconds(30)));
+
+    sched.suspend(b);
+    sched.suspend(c);
+    TickClock::ticks = 30;
+    sched.run_once();
+    CHECK(log == "bca");
+}
+
+TEST_CASE("scheduler_block_and_run_loop") {
+    Sched sched;
+    ulink::List<Sched::Task> waiters;
+    int produced = 0;
+    int consumed = 0;
+
+    struct Consumer : Sched::Task {
+        Consumer(Sched& s, ulink::List<Sched::Task>& w, int& p, int& c) : Sched::Task(&step, 3), s(s), w(w), p(p), c(c) {}
+        static void step(Sched::Task& t) {
+            auto& self = static_cast<Consumer&>(t);
+            if (self.c == self.p) { self.s.block(self, self.w); return; }
+            self.c++;
+        }
+        Sched& s; ulink::List<Sched::Task>& w; int& p; int& c;
+    };
+
+    struct Producer : Sched::Task {
+        Producer(Sched& s, ulink::List<Sched::Task>& w, int& p) : Sched::Task(&step, 1), s(s), w(w), p(p) {}
+        static void step(Sched::Task& t) {
+            auto& self = static_cast<Producer&>(t);
+            if (++self.p == 5) { self.s.suspend(self); }
+            self.s.wake_all(self.w);
+        }
+        Sched& s; ulink::List<Sched::Task>& w; int& p;
+    };
+
+    Consumer consumer(sched, waiters, produced, consumed);
+    Producer producer(sched, waiters, produced);
+    sched.ready(consumer);
+    sched.ready(producer);
+
+    int idleCalls = 0;
+    sched.run([&] (Sched::time_point next) {
+        CHECK(next == Sched::time_point::max());
+        idleCalls++;
+        sched.stop();
+    });
+
+    CHECK(produced == 5);
+    CHECK(consumed == 5);
+    CHECK(idleCalls == 1);
+    CHECK(consumer.state() == Sched::Task::State::Blocked);
+    CHECK(sched.wake_one(waiters));
+    CHECK(consumer.state() == Sched::Task::State::Ready);
+}
+
+TEST_CASE("scheduler_priority_is_clamped") {
+    Sched sched;
+    std::string log;
+    // 8 priorities : 7 is the highest
+    Recorder top(log, 't', 200);
+    Recorder mid(log, 'm', 6);
+    Recorder low(log, 'l', 0);
+
+    CHECK(top.priority() == 7);
+
+    sched.ready(low);
+    sched.ready(mid);
+    sched.ready(top);
+    sched.run_once();
+    CHECK(log == "t");
+
+    sched.set_priority(low, 255);
+    CHECK(low.priority() == 7);
+    sched.suspend(top);
+    sched.run_once();
+    CHECK(log == "tl");
+
+    sched.set_priority(low, 0);
+    sched.run_once();
+    CHECK(log == "tlm");
+}
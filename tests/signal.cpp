@@ -0,0 +1,131 @@
+#include "doctest.h"
+
+#include "ulink_signal.hpp"
+
+#include <string>
+
+namespace {
+
+    using Changed = ulink::Signal<int>;
+
+    struct Recorder : Changed::Slot {
+        Recorder(std::string& log, char name) : Slot(&onChanged), log(log), name(name) {}
+
+        static void onChanged(Slot& s, int value) {
+            auto& self = static_cast<Recorder&>(s);
+            self.log += self.name;
+            self.last = value;
+            if (self.action) self.action(self);
+        }
+
+        std::string& log;
+        char name;
+        int last = 0;
+        void (*action)(Recorder&) = nullptr;
+        Recorder* other = nullptr;
+        Changed* signal = nullptr;
+    };
+
+}
+
+TEST_CASE("signal_connect_emit_disconnect") {
+    Changed changed;
+    std::string log;
+    Recorder a(log, 'a');
+    Recorder b(log, 'b');
+
+    CHECK(changed.empty());
+    changed.connect(a);
+    changed.connect(b);
+    CHECK(changed.size() == 2);
+
+    changed.emit(3);
+    CHECK(log == "ab");
+    CHECK(b.last == 3);
+
+    changed.disconnect(a);
+    changed(4);
+    CHECK(log == "abb");
+    CHECK(a.last == 3);
+
+    {
+        Recorder c(log, 'c');
+        changed.connect(c);
+        changed(5);
+    }
+    changed(6);
+    CHECK(log == "abbbcb");
+
+    int sum = 0;
+    auto lambda = ulink::make_slot<int>([&sum] (int v) { sum += v; });
+    changed.connect(lambda);
+    changed(10);
+    CHECK(sum == 10);
+    CHECK(lambda.connected());
+}
+
+TEST_CASE("signal_reentrant_disconnect") {
+    Changed changed;
+    std::string log;
+    Recorder a(log, 'a');
+    Recorder b(log, 'b');
+    Recorder c(log, 'c');
+
+    // "a" disconnects itself, "b" disconnects "c"
+    a.action = [] (Recorder& r) { r.disconnect(); };
+    b.other = &c;
+    b.action = [] (Recorder& r) { r.other->disconnect(); };
+
+    changed.connect(a);
+    changed.connect(b);
+    changed.connect(c);
+
+    changed(1);
+    CHECK(log == "ab");
+    CHECK(changed.size() == 1);
+
+    changed(2);
+    CHECK(log == "abb");
+}
+
+TEST_CASE("signal_reentrant_connect_and_emit") {
+    Changed changed;
+    std::string log;
+    Recorder a(log, 'a');
+    Recorder b(log, 'b');
+    Recorder late(log, 'l');
+
+    // "a" connects "late", which is appended and called by this emission
+    a.other = &late;
+    a.signal = &changed;
+    a.action = [] (Recorder& r) { if (!r.other->connected()) r.signal->connect(*r.other); };
+
+    // "b" emits again once, the nested emission calls "late" too
+    b.signal = &changed;
+    b.action = [] (Recorder& r) { if (r.last == 1) r.signal->emit(2); };
+
+    changed.connect(a);
+    changed.connect(b);
+
+    changed(1);
+    CHECK(log == "ababll");
+    CHECK(changed.size() == 3);
+}
+
+TEST_CASE("signal_disconnect_all_during_emit") {
+    Changed changed;
+    std::string log;
+    Recorder a(log, 'a');
+    Recorder b(log, 'b');
+
+    a.signal = &changed;
+    a.action = [] (Recorder& r) { r.signal->disconnect_all(); };
+
+    changed.connect(a);
+    changed.connect(b);
+
+    changed(1);
+    CHECK(log == "a");
+    CHECK(changed.empty());
+    CHECK(!b.connected());
+}
@@ -0,0 +1,98 @@
+#include "doctest.h"
+
+#include "ulink_skiplist.hpp"
+
+#include <vector>
+
+struct Timer : ulink::SkipNode<Timer> {
+    Timer(int d = 0) : deadline(d) {}
+    bool operator<(const Timer& other) const { return deadline < other.deadline; }
+    int deadline;
+};
+
+TEST_CASE("skiplist_insert_in_order") {
+    ulink::SkipList<Timer> timers;
+
+    CHECK(timers.empty());
+
+    std::vector<Timer> nodes(1000);
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        nodes[i].deadline = static_cast<int>((i * 389) % nodes.size());
+        timers.insert(nodes[i]);
+    }
+
+    CHECK(timers.size() == nodes.size());
+    CHECK(timers.front().deadline == 0);
+    CHECK(timers.back().deadline == 999);
+
+    int expected = 0;
+    for (auto& t : timers) CHECK(t.deadline == expected++);
+
+    expected = 999;
+    for (auto it = timers.rbegin(); it != timers.rend(); ++it) CHECK((*it).deadline == expected--);
+}
+
+TEST_CASE("skiplist_bounds") {
+    ulink::SkipList<Timer> timers;
+    Timer a(10); Timer b(20); Timer c(20); Timer d(30);
+
+    timers.insert(d);
+    timers.insert(b);
+    timers.insert(a);
+    timers.insert(c);
+
+    CHECK(&(*timers.lower_bound(Timer(20))) == &b);
+    CHECK(&(*timers.upper_bound(Timer(20))) == &d);
+    CHECK(timers.lower_bound(Timer(31)) == timers.end());
+    CHECK(timers.find(Timer(25)) == timers.end());
+    CHECK(&(*timers.find(Timer(10))) == &a);
+
+    auto range = timers.equal_range(Timer(20));
+    auto it = range.first;
+    CHECK(&(*it) == &b);
+    ++it;
+    CHECK(&(*it) == &c);
+    ++it;
+    CHECK(it == range.second);
+}
+
+TEST_CASE("skiplist_erase_and_auto_unlink") {
+    ulink::SkipList<Timer> timers;
+
+    std::vector<Timer> nodes(200);
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        nodes[i].deadline = static_cast<int>(i);
+        timers.insert(nodes[i]);
+    }
+
+    for (auto it = timers.begin(); it != timers.end();) {
+        it = (it->deadline % 3 != 0) ? timers.erase(it) : ++it;
+    }
+
+    CHECK(timers.size() == 67);
+
+    // the upper levels must still lead to the right nodes
+    for (int i = 0; i < 200; i += 3) {
+        CHECK(timers.find(Timer(i))->deadline == i);
+    }
+    CHECK(timers.find(Timer(4)) == timers.end());
+
+    nodes[99].remove();
+    CHECK(timers.find(Timer(99)) == timers.end());
+    CHECK(timers.lower_bound(Timer(99))->deadline == 102);
+
+    {
+        Timer temp(100);
+        timers.insert(temp);
+        CHECK(timers.lower_bound(Timer(99))->deadline == 100);
+    }
+
+    CHECK(timers.lower_bound(Timer(99))->deadline == 102);
+
+    timers.pop_front();
+    CHECK(timers.front().deadline == 3);
+
+    timers.clear();
+    CHECK(timers.empty());
+    CHECK(!nodes[3].isLinked());
+}
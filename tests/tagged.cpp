@@ -0,0 +1,148 @@
+#include "doctest.h"
+
+#include "ulink_tagged.hpp"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    enum Flag : std::size_t { Dirty, Pinned, InFlight };
+
+    struct Page : ulink::TaggedNode<Page, 3> {
+        explicit Page(int id) : id(id) {}
+        int id;
+    };
+
+    template<typename node_t, std::size_t index, typename = void>
+    struct HasFlag : std::false_type {};
+
+    template<typename node_t, std::size_t index>
+    struct HasFlag<node_t, index, std::void_t<decltype(std::declval<node_t&>().template set_flag<index>())>> : std::true_type {};
+
+    std::vector<int> ids(const ulink::TaggedList<Page>& list) {
+        std::vector<int> v;
+        for (auto& p : list) {
+            v.push_back(p.id);
+        }
+        return v;
+    }
+
+}
+
+TEST_CASE("tagged_node_size") {
+    struct Plain : ulink::TaggedNode<Plain> { void* payload; };
+    CHECK(sizeof(ulink::TaggedNode<Plain>) == 2 * sizeof(void*));
+    CHECK(sizeof(Plain) == 3 * sizeof(void*));
+    CHECK(ulink::TaggedNode<Plain>::kLinkBits >= 2);
+}
+
+TEST_CASE("tagged_flags_survive_list_operations") {
+
+    Page p1(1), p2(2), p3(3), p4(4);
+
+    p2.set_flag<Dirty>();
+    p2.set_flag<InFlight>();
+    p3.set_flag<Pinned>();
+
+    CHECK(p2.flags() == 0b101);
+    CHECK(p3.flags() == 0b010);
+    CHECK(!p2.isLinked());
+
+    ulink::TaggedList<Page> list;
+
+    list.push_back(p2);
+    list.push_front(p1);
+    list.push_back(p4);
+    list.insert_before(std::find_if(list.begin(), list.end(), [] (const Page& p) { return p.id == 4; }), p3);
+
+    CHECK(ids(list) == std::vector<int> { 1, 2, 3, 4 });
+    CHECK(list.size() == 4);
+    CHECK(p2.flags() == 0b101);
+    CHECK(p3.flags() == 0b010);
+    CHECK(p1.flags() == 0);
+
+    // flags set while linked leave the links intact
+    p1.set_flags(0b111);
+    p4.set_flag<Pinned>();
+    p2.clear_flag<Dirty>();
+    CHECK(ids(list) == std::vector<int> { 1, 2, 3, 4 });
+
+    std::vector<int> reversed;
+    for (auto it = list.rbegin(); it != list.rend(); ++it) {
+        reversed.push_back(it->id);
+    }
+    CHECK(reversed == std::vector<int> { 4, 3, 2, 1 });
+
+    auto it = list.erase(++list.begin());
+    CHECK(it->id == 3);
+    CHECK(!p2.isLinked());
+    CHECK(p2.flags() == 0b100);
+
+    p3.remove();
+    CHECK(ids(list) == std::vector<int> { 1, 4 });
+    CHECK(p3.flag<Pinned>());
+    CHECK(!p3.flag<Dirty>());
+
+    ulink::TaggedList<Page> other;
+    other.push_back(p2);
+    other.push_back(p3);
+    list.splice(--list.end(), other);
+    CHECK(other.empty());
+    CHECK(ids(list) == std::vector<int> { 1, 2, 3, 4 });
+    CHECK(p1.flags() == 0b111);
+    CHECK(p4.flags() == 0b010);
+
+    list.pop_front();
+    list.pop_back();
+    CHECK(ids(list) == std::vector<int> { 2, 3 });
+    CHECK(list.front().flag<InFlight>());
+    CHECK(list.back().flag<Pinned>());
+
+    {
+        Page temp(5);
+        temp.set_flag<Dirty>();
+        list.push_back(temp);
+        CHECK(list.size() == 3);
+    }
+    CHECK(ids(list) == std::vector<int> { 2, 3 });
+
+    list.clear();
+    CHECK(list.empty());
+    CHECK(p2.flags() == 0b100);
+    CHECK(p1.flags() == 0b111);
+}
+
+TEST_CASE("tagged_flag_index_is_bounded") {
+
+    struct Pair : ulink::TaggedNode<Pair> {};
+
+    // 2 flags by default : index 2 would be a bit of "prev"
+    static_assert(HasFlag<Pair, 1>::value);
+    static_assert(!HasFlag<Pair, 2>::value);
+    static_assert(HasFlag<Page, 2>::value);
+    static_assert(!HasFlag<Page, 3>::value);
+
+    ulink::TaggedList<Pair> list;
+    Pair a, b, c;
+    list.push_back(a);
+    list.push_back(b);
+    list.push_back(c);
+
+    // bits past the flag count are dropped
+    b.set_flags(0xFF);
+    CHECK(b.flags() == 0b11);
+    CHECK(b.flag<1>());
+
+    std::size_t count = 0;
+    for (auto it = list.rbegin(); it != list.rend(); ++it) {
+        count++;
+    }
+    CHECK(count == 3);
+    CHECK(&list.back() == &c);
+    b.remove();
+    CHECK(list.size() == 2);
+    CHECK(b.flags() == 0b11);
+}
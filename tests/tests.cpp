@@ -4,6 +4,14 @@
 #include "doctest.h"
 
 #include "ulink.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#if defined(__cpp_lib_ranges)
+#include <ranges>
+#endif
+
 struct Element : ulink::Node<Element> { int value; };
 
 TEST_CASE("empty_and_push") {
@@ -128,7 +136,11 @@ TEST_CASE("erase_pop_clear") {
 
     { i = 1; for (auto& n : list) CHECK(n.value == values[i++]); }
 
-    list.erase(list.end());
+    // erasing end() leaves the list untouched
+    CHECK(list.erase(list.end()) == list.end());
+    CHECK(list.size() == 3);
+
+    list.pop_back();
     CHECK(list.size() == 2);
 
     list.pop_front();
@@ -139,6 +151,60 @@ TEST_CASE("erase_pop_clear") {
     CHECK(list.empty());
 }
 
+TEST_CASE("erase_returns_next_and_erase_if") {
+    ulink::List<Element> list;
+    Element e[8];
+    for (int i = 0; i < 8; i++) { e[i].value = i; list.push_back(e[i]); }
+
+    // single pass filter with the returned iterator
+    for (auto it = list.begin(); it != list.end();) {
+        it = (it->value % 4 == 0) ? list.erase(it) : ++it;
+    }
+    CHECK(list.size() == 6);
+    CHECK(list.front().value == 1);
+    CHECK(!e[4].isLinked());
+
+    auto first = list.begin(); ++first;
+    auto last = first; ++last; ++last;
+    CHECK(list.erase(first, last) == last);
+    CHECK(last->value == 5);
+    CHECK(list.size() == 4);
+
+    CHECK(list.erase_if([] (const Element& n) { return n.value & 1; }) == 3);
+    CHECK(list.size() == 1);
+    CHECK(list.front().value == 6);
+
+    CHECK(list.erase(list.begin()) == list.end());
+    CHECK(list.empty());
+}
+
+TEST_CASE("stable_iteration") {
+    ulink::List<Element> list;
+    ulink::List<Element> odd;
+    Element e[6];
+    for (int i = 0; i < 6; i++) { e[i].value = i; list.push_back(e[i]); }
+
+    // the current node may be removed or moved to another list
+    int visited = 0;
+    for (auto& n : list.stable()) {
+        visited++;
+        if (n.value & 1) odd.push_back(n);
+        else if (n.value == 4) n.remove();
+    }
+
+    CHECK(visited == 6);
+    CHECK(list.size() == 2);
+    CHECK(odd.size() == 3);
+    CHECK(list.back().value == 2);
+
+    auto it = list.stable_begin();
+    (*it).remove();
+    ++it;
+    CHECK(it->value == 2);
+    ++it;
+    CHECK(it == list.stable_end());
+}
+
 TEST_CASE("splice_append") {
     ulink::List<Element> list;
     Element a1; a1.value = 1; Element a2; a2.value = 2;
@@ -225,3 +291,228 @@ TEST_CASE("splice_range_iterator") {
     }
 }
 
+
+TEST_CASE("insert_sorted_and_hint") {
+    auto less = [] (const Element& a, const Element& b) { return a.value < b.value; };
+
+    ulink::List<Element> list;
+    Element e[8];
+    const int values[] = { 5, 1, 4, 4, 9, 0, 7, 4 };
+
+    for (int i = 0; i < 8; i++) {
+        e[i].value = values[i];
+        list.insert_sorted(e[i], less);
+    }
+
+    const int expected[] = { 0, 1, 4, 4, 4, 5, 7, 9 };
+    int i = 0; for (auto& n : list) CHECK(n.value == expected[i++]);
+
+    // equal values keep their insertion order
+    auto it = list.begin(); ++it; ++it;
+    CHECK(&(*it) == &e[2]); ++it;
+    CHECK(&(*it) == &e[3]); ++it;
+    CHECK(&(*it) == &e[7]);
+
+    // hints on either side of the insertion point
+    Element a; a.value = 6;
+    list.insert_sorted_hint(list.begin(), a, less);
+    Element b; b.value = 2;
+    list.insert_sorted_hint(list.end(), b, less);
+    Element c; c.value = 10;
+    auto last = list.insert_sorted_hint(list.begin(), c, less);
+    CHECK(&(*last) == &c);
+
+    // reinsertion with the node itself as hint
+    e[5].value = 8;
+    list.insert_sorted_hint(ulink::List<Element>::iterator(&e[5]), e[5], less);
+
+    const int expected2[] = { 1, 2, 4, 4, 4, 5, 6, 7, 8, 9, 10 };
+    i = 0; for (auto& n : list) CHECK(n.value == expected2[i++]);
+    CHECK(list.size() == 11);
+}
+
+TEST_CASE("sort_and_merge") {
+    auto less = [] (const Element& a, const Element& b) { return a.value < b.value; };
+
+    ulink::List<Element> list;
+    Element e[9];
+    const int values[] = { 5, 3, 8, 3, 1, 9, 0, 3, 7 };
+    for (int i = 0; i < 9; i++) {
+        e[i].value = values[i];
+        list.push_back(e[i]);
+    }
+
+    list.sort(less);
+
+    const int expected[] = { 0, 1, 3, 3, 3, 5, 7, 8, 9 };
+    int i = 0; for (auto& n : list) CHECK(n.value == expected[i++]);
+    i = 8; for (auto it = list.rbegin(); it != list.rend(); ++it) CHECK((*it).value == expected[i--]);
+
+    // stability
+    auto it = list.begin(); ++it; ++it;
+    CHECK(&(*it) == &e[1]); ++it;
+    CHECK(&(*it) == &e[3]); ++it;
+    CHECK(&(*it) == &e[7]);
+
+    ulink::List<Element> other;
+    Element o[4];
+    const int otherValues[] = { -1, 3, 6, 12 };
+    for (int j = 0; j < 4; j++) {
+        o[j].value = otherValues[j];
+        other.push_back(o[j]);
+    }
+
+    list.merge(other, less);
+
+    CHECK(other.empty());
+    CHECK(list.size() == 13);
+
+    const int merged[] = { -1, 0, 1, 3, 3, 3, 3, 5, 6, 7, 8, 9, 12 };
+    i = 0; for (auto& n : list) CHECK(n.value == merged[i++]);
+    CHECK(&list.front() == &o[0]);
+    CHECK(&list.back() == &o[3]);
+
+    // equal nodes of "other" come after those of the list
+    it = list.begin(); for (int j = 0; j < 6; j++) ++it;
+    CHECK(&(*it) == &o[1]);
+
+    ulink::List<Element> empty;
+    empty.sort(less);
+    CHECK(empty.empty());
+}
+
+TEST_CASE("std_algorithms_on_iterators") {
+    ulink::List<Element> list;
+    Element e[5];
+    for (int i = 0; i < 5; i++) { e[i].value = i * 10; list.push_back(e[i]); }
+
+    static_assert(std::is_same_v<
+        std::iterator_traits<ulink::List<Element>::iterator>::iterator_category,
+        std::bidirectional_iterator_tag>);
+
+    auto it = std::find_if(list.begin(), list.end(), [] (const Element& n) { return n.value == 30; });
+    CHECK(&(*it) == &e[3]);
+    CHECK(std::distance(list.begin(), it) == 3);
+    CHECK(std::prev(list.end())->value == 40);
+    CHECK(std::next(list.begin(), 2)->value == 20);
+
+    auto post = it++;
+    CHECK(&(*post) == &e[3]);
+    CHECK(&(*it) == &e[4]);
+    it--;
+    CHECK(&(*it) == &e[3]);
+
+    const auto& clist = list;
+    ulink::List<Element>::const_iterator cit = it;
+    CHECK(cit->value == 30);
+    CHECK(std::count_if(clist.begin(), clist.end(), [] (const Element& n) { return n.value > 15; }) == 3);
+    CHECK(std::distance(list.rbegin(), list.rend()) == 5);
+
+    int sum = 0;
+    std::for_each(std::make_reverse_iterator(list.end()), std::make_reverse_iterator(list.begin()),
+        [&sum] (const Element& n) { sum = sum * 2 + n.value; });
+    CHECK(sum == 40 * 16 + 30 * 8 + 20 * 4 + 10 * 2);
+}
+
+#if defined(__cpp_lib_ranges)
+
+static_assert(std::bidirectional_iterator<ulink::List<Element>::iterator>);
+static_assert(std::bidirectional_iterator<ulink::List<Element>::const_reverse_iterator>);
+static_assert(std::ranges::bidirectional_range<ulink::List<Element>>);
+static_assert(std::ranges::bidirectional_range<const ulink::List<Element>>);
+
+TEST_CASE("ranges_views_over_list") {
+    ulink::List<Element> list;
+    Element e[6];
+    for (int i = 0; i < 6; i++) { e[i].value = i; list.push_back(e[i]); }
+
+    auto odd = list
+        | std::views::filter([] (const Element& n) { return n.value & 1; })
+        | std::views::transform([] (const Element& n) { return n.value * 10; })
+        | std::views::take(2);
+
+    int expected[] = { 10, 30 };
+    int i = 0;
+    for (int v : odd) CHECK(v == expected[i++]);
+    CHECK(i == 2);
+
+    CHECK(std::ranges::find(list, 4, &Element::value) != list.end());
+    CHECK(std::ranges::distance(list | std::views::reverse) == 6);
+    CHECK((*std::ranges::max_element(list, {}, &Element::value)).value == 5);
+}
+
+#endif
+
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201907L
+
+namespace {
+
+    struct Command : ulink::Node<Command> {
+        constexpr Command(int i = 0) : id(i) {}
+        int id;
+    };
+
+    constexpr int buildAndWalk() {
+        Command c[5] = { 4, 1, 3, 0, 2 };
+        ulink::List<Command> list;
+        for (auto& n : c) list.push_back(n);
+
+        list.sort([] (const Command& a, const Command& b) { return a.id < b.id; });
+        list.erase_if([] (const Command& n) { return n.id == 3; });
+        list.pop_front();
+
+        // 1, 2, 4 read as a base 10 number
+        int digits = 0;
+        for (const auto& n : list) digits = digits * 10 + n.id;
+        return digits * 10 + static_cast<int>(list.size());
+    }
+
+    constexpr bool spliceAndReverse() {
+        Command a[3] = { 1, 2, 3 };
+        Command b[2] = { 4, 5 };
+        ulink::List<Command> l1;
+        ulink::List<Command> l2;
+        for (auto& n : a) l1.push_back(n);
+        for (auto& n : b) l2.push_front(n);
+
+        l1.splice(l1.begin(), l2);
+
+        int expected[] = { 3, 2, 1, 4, 5 };
+        int i = 0;
+        for (auto it = l1.rbegin(); it != l1.rend(); ++it) {
+            if (it->id != expected[i++]) return false;
+        }
+
+        {
+            // leaves the list on destruction
+            Command temp(9);
+            l1.insert_after(l1.begin(), temp);
+        }
+
+        return l2.empty() && l1.size() == 5 && l1.front().id == 5 && a[0].isLinked();
+    }
+
+}
+
+static_assert(buildAndWalk() == 1243);
+static_assert(spliceAndReverse());
+
+// linked at compile time, no startup code writes the links
+struct CommandTable {
+    Command commands[3] = { 7, 8, 9 };
+    ulink::List<Command> list;
+    constexpr CommandTable() { for (auto& c : commands) list.push_back(c); }
+};
+
+constinit CommandTable commandTable;
+
+TEST_CASE("constexpr_list_at_runtime") {
+    CHECK(buildAndWalk() == 1243);
+    CHECK(spliceAndReverse());
+
+    int expected = 7;
+    for (auto& c : commandTable.list) CHECK(c.id == expected++);
+    CHECK(expected == 10);
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include "doctest.h"
+
+#include "ulink_tlsf.hpp"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+TEST_CASE("tlsf_allocate_and_coalesce") {
+    alignas(16) static unsigned char region[64 * 1024];
+    ulink::Tlsf heap(region, sizeof(region));
+
+    CHECK(heap.allocate(0) == nullptr);
+
+    // the whole region as a single block
+    void* all = heap.allocate(60 * 1024);
+    REQUIRE(all != nullptr);
+    CHECK(heap.allocate(8 * 1024) == nullptr);
+    heap.deallocate(all);
+
+    std::vector<void*> blocks;
+    while (void* p = heap.allocate(100)) {
+        CHECK(reinterpret_cast<std::uintptr_t>(p) % heap.alignment == 0);
+        CHECK(heap.usable_size(p) >= 100);
+        blocks.push_back(p);
+    }
+    CHECK(blocks.size() > 400);
+
+    // free every other block then the rest : every free must merge back
+    for (std::size_t i = 0; i < blocks.size(); i += 2) heap.deallocate(blocks[i]);
+    CHECK(heap.allocate(1024) == nullptr);
+    for (std::size_t i = 1; i < blocks.size(); i += 2) heap.deallocate(blocks[i]);
+
+    all = heap.allocate(60 * 1024);
+    CHECK(all != nullptr);
+    heap.deallocate(all);
+}
+
+TEST_CASE("tlsf_random_pattern") {
+    alignas(16) static unsigned char region[256 * 1024];
+    ulink::Tlsf heap(region, sizeof(region));
+
+    struct Allocation { unsigned char* ptr; std::size_t size; unsigned char tag; };
+    std::vector<Allocation> live;
+    std::mt19937 rng(3);
+
+    for (int step = 0; step < 20000; step++) {
+        if (live.empty() || rng() % 3) {
+            const std::size_t size = 1 + rng() % 2000;
+            auto* p = static_cast<unsigned char*>(heap.allocate(size));
+            if (p) {
+                const auto tag = static_cast<unsigned char>(step);
+                std::memset(p, tag, size);
+                live.push_back({ p, size, tag });
+            }
+        }
+        else {
+            const std::size_t i = rng() % live.size();
+            auto a = live[i];
+            bool intact = true;
+            for (std::size_t j = 0; j < a.size; j++) intact = intact && (a.ptr[j] == a.tag);
+            CHECK(intact);
+            heap.deallocate(a.ptr);
+            live[i] = live.back();
+            live.pop_back();
+        }
+    }
+
+    for (auto& a : live) heap.deallocate(a.ptr);
+
+    void* all = heap.allocate(200 * 1024);
+    CHECK(all != nullptr);
+    heap.deallocate(all);
+}
+
+TEST_CASE("tlsf_tiny_region") {
+    alignas(16) static unsigned char region[16];
+    ulink::Tlsf heap(region, sizeof(region));
+    CHECK(heap.allocate(1) == nullptr);
+    heap.deallocate(nullptr);
+}
@@ -0,0 +1,186 @@
+#include "doctest.h"
+
+#include "ulink_unrolled.hpp"
+
+#include <vector>
+
+namespace {
+
+    struct Widget {
+        int id;
+    };
+
+    using WidgetList = ulink::UnrolledList<Widget*, 4>;
+
+    std::vector<int> ids(const WidgetList& list) {
+        std::vector<int> v;
+        for (const Widget* w : list) {
+            v.push_back(w->id);
+        }
+        return v;
+    }
+
+}
+
+TEST_CASE("unrolled_block_layout") {
+    using Default = ulink::UnrolledList<Widget*>;
+    CHECK(sizeof(Default::Block) == 64);
+    CHECK(alignof(Default::Block) == 64);
+    CHECK(Default::block_size() == (sizeof(void*) == 8 ? 5 : 13));
+}
+
+TEST_CASE("unrolled_push_pop_and_pool_recycling") {
+
+    Widget widgets[20];
+    for (int i = 0; i < 20; i++) {
+        widgets[i].id = i;
+    }
+
+    WidgetList::Block blocks[4];
+    WidgetList::BlockPool pool;
+    pool.add(blocks, 4);
+    CHECK(pool.available() == 4);
+
+    WidgetList list(pool);
+    CHECK(list.empty());
+    CHECK(list.begin() == list.end());
+
+    for (int i = 5; i < 10; i++) {
+        CHECK(list.push_back(&widgets[i]));
+    }
+    for (int i = 4; i >= 0; i--) {
+        CHECK(list.push_front(&widgets[i]));
+    }
+
+    CHECK(list.size() == 10);
+    CHECK(ids(list) == std::vector<int> { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    CHECK(list.front()->id == 0);
+    CHECK(list.back()->id == 9);
+    // push_front opens a right-aligned block : 0 | 1 2 3 4 | 5 6 7 8 | 9
+    CHECK(list.block_count() == 4);
+    CHECK(pool.available() == 0);
+
+    // the last block still has room, then the pool is exhausted
+    for (int i = 10; i < 13; i++) {
+        CHECK(list.push_back(&widgets[i]));
+    }
+    CHECK(!list.push_back(&widgets[13]));
+    CHECK(list.size() == 13);
+
+    std::vector<int> reversed;
+    for (auto it = list.end(); it != list.begin();) {
+        --it;
+        reversed.push_back((*it)->id);
+    }
+    CHECK(reversed == std::vector<int> { 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 });
+
+    list.pop_front();
+    CHECK(list.block_count() == 3);
+    CHECK(pool.available() == 1);
+    list.pop_back();
+    CHECK(list.block_count() == 3);
+    CHECK(ids(list) == std::vector<int> { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 });
+
+    // a second list drawing from the same pool
+    {
+        WidgetList other(pool);
+        CHECK(other.push_back(&widgets[19]));
+        CHECK(pool.available() == 0);
+    }
+    CHECK(pool.available() == 1);
+
+    list.clear();
+    CHECK(list.empty());
+    CHECK(pool.available() == 4);
+}
+
+TEST_CASE("unrolled_erase") {
+
+    Widget widgets[12];
+    for (int i = 0; i < 12; i++) {
+        widgets[i].id = i;
+    }
+
+    WidgetList::Block blocks[8];
+    WidgetList::BlockPool pool;
+    pool.add(blocks, 8);
+
+    WidgetList list(pool);
+    for (auto& w : widgets) {
+        list.push_back(&w);
+    }
+    CHECK(list.block_count() == 3);
+
+    // near the front of a block : the front side shifts
+    auto it = list.erase(std::next(list.begin(), 1));
+    CHECK((*it)->id == 2);
+    // near the back of a block : the back side shifts
+    it = list.erase(std::next(list.begin(), 5));
+    CHECK((*it)->id == 7);
+    // last of a block
+    it = list.erase(std::next(list.begin(), 5));
+    CHECK((*it)->id == 8);
+    CHECK(ids(list) == std::vector<int> { 0, 2, 3, 4, 5, 8, 9, 10, 11 });
+    CHECK(list.size() == 9);
+
+    CHECK(list.erase_if([] (Widget* w) { return w->id >= 8; }) == 4);
+    CHECK(ids(list) == std::vector<int> { 0, 2, 3, 4, 5 });
+    CHECK(list.block_count() == 2);
+
+    // erasing every pointer releases every block
+    for (auto e = list.begin(); e != list.end();) {
+        e = list.erase(e);
+    }
+    CHECK(list.empty());
+    CHECK(list.block_count() == 0);
+    CHECK(pool.available() == 8);
+}
+
+TEST_CASE("unrolled_heavy_erase_keeps_blocks_filled") {
+
+    constexpr int count = 400;
+    std::vector<Widget> widgets(count);
+    for (int i = 0; i < count; i++) {
+        widgets[i].id = i;
+    }
+
+    std::vector<WidgetList::Block> blocks(count);
+    WidgetList::BlockPool pool;
+    pool.add(blocks.data(), blocks.size());
+
+    WidgetList list(pool);
+    for (auto& w : widgets) {
+        CHECK(list.push_back(&w));
+    }
+    CHECK(list.block_count() == count / 4);
+
+    // erase three pointers out of four, one at a time
+    std::vector<int> expected;
+    for (auto it = list.begin(); it != list.end();) {
+        if ((*it)->id % 4 != 0) {
+            it = list.erase(it);
+        }
+        else {
+            expected.push_back((*it)->id);
+            ++it;
+        }
+    }
+    CHECK(ids(list) == expected);
+    CHECK(list.size() == count / 4);
+
+    // every block but the last one is at least half full
+    CHECK(list.block_count() <= list.size() / 2 + 1);
+
+    std::vector<int> reversed;
+    for (auto it = list.end(); it != list.begin();) {
+        --it;
+        reversed.push_back((*it)->id);
+    }
+    CHECK(reversed == std::vector<int>(expected.rbegin(), expected.rend()));
+
+    // erase_if packs the survivors into full blocks
+    CHECK(list.erase_if([] (Widget* w) { return w->id % 8 != 0; }) == count / 8);
+    CHECK(list.size() == count / 8);
+    CHECK(list.block_count() == (count / 8 + 3) / 4);
+    CHECK(pool.available() == blocks.size() - list.block_count());
+}
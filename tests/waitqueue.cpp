@@ -0,0 +1,110 @@
+#include "doctest.h"
+
+#if defined(__linux__)
+
+#include "ulink_waitqueue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST_CASE("waitqueue_wakes_in_fifo_order") {
+    ulink::WaitQueue q;
+    std::atomic<int> order { 0 };
+    int woken[3] = { -1, -1, -1 };
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 3; i++) {
+        threads.emplace_back([&, i] {
+            ulink::WaitQueue::Waiter w;
+            q.prepare(w);
+            q.park(w);
+            CHECK(q.finish(w));
+            woken[i] = order++;
+        });
+        // waiters are queued one after the other
+        while (q.size() != static_cast<std::size_t>(i + 1)) std::this_thread::yield();
+    }
+
+    for (int i = 0; i < 3; i++) {
+        CHECK(q.notify_one());
+        while (order.load() != i + 1) std::this_thread::yield();
+    }
+
+    for (auto& t : threads) t.join();
+
+    CHECK(woken[0] == 0);
+    CHECK(woken[1] == 1);
+    CHECK(woken[2] == 2);
+    CHECK(!q.notify_one());
+}
+
+TEST_CASE("waitqueue_notify_all") {
+    ulink::WaitQueue q;
+    std::atomic<bool> ready { false };
+    std::atomic<int> done { 0 };
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&] {
+            q.wait([&] { return ready.load(); });
+            done++;
+        });
+    }
+
+    while (q.size() != 4) std::this_thread::yield();
+
+    ready = true;
+    CHECK(q.notify_all() == 4);
+
+    for (auto& t : threads) t.join();
+    CHECK(done == 4);
+    CHECK(q.empty());
+}
+
+TEST_CASE("waitqueue_timeout_dequeues_waiter") {
+    ulink::WaitQueue q;
+
+    CHECK(!q.wait_for([] { return false; }, std::chrono::milliseconds(20)));
+    CHECK(q.empty());
+
+    {
+        ulink::WaitQueue::Waiter w;
+        q.prepare(w);
+        CHECK(!q.park_for(w, std::chrono::milliseconds(5)));
+        CHECK(q.size() == 1);
+        // leaving the scope without finish()
+    }
+
+    CHECK(q.empty());
+    CHECK(!q.notify_one());
+}
+
+TEST_CASE("waitqueue_with_external_lock") {
+    ulink::WaitQueue q;
+    std::mutex m;
+    int value = 0;
+
+    std::thread consumer([&] {
+        std::unique_lock<std::mutex> lock(m);
+        while (value == 0) q.wait(lock);
+        value++;
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(m);
+        value = 1;
+    }
+    q.notify_one();
+    consumer.join();
+
+    CHECK(value == 2);
+
+    std::unique_lock<std::mutex> lock(m);
+    CHECK(!q.wait_for(lock, std::chrono::milliseconds(5)));
+    CHECK(lock.owns_lock());
+}
+
+#endif
@@ -0,0 +1,198 @@
+#include "doctest.h"
+
+#include "ulink_xorlist.hpp"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    struct Item : ulink::XorNode<Item> {
+        explicit Item(int id) : id(id) {}
+        int id;
+    };
+
+    template<typename iterator_t, typename = void>
+    struct Erasable : std::false_type {};
+
+    template<typename iterator_t>
+    struct Erasable<iterator_t, std::void_t<decltype(std::declval<ulink::XorList<Item>&>().erase(std::declval<iterator_t>()))>> : std::true_type {};
+
+    template<typename iterator_t, typename = void>
+    struct Insertable : std::false_type {};
+
+    template<typename iterator_t>
+    struct Insertable<iterator_t, std::void_t<decltype(std::declval<ulink::XorList<Item>&>().insert_before(std::declval<iterator_t>(), std::declval<Item&>()))>> : std::true_type {};
+
+    template<typename iterator_t, typename = void>
+    struct Splicable : std::false_type {};
+
+    template<typename iterator_t>
+    struct Splicable<iterator_t, std::void_t<decltype(std::declval<ulink::XorList<Item>&>().splice(std::declval<iterator_t>(), std::declval<ulink::XorList<Item>&>()))>> : std::true_type {};
+
+    std::vector<int> forward(const ulink::XorList<Item>& list) {
+        std::vector<int> v;
+        for (auto& i : list) {
+            v.push_back(i.id);
+        }
+        return v;
+    }
+
+    std::vector<int> backward(const ulink::XorList<Item>& list) {
+        std::vector<int> v;
+        for (auto it = list.rbegin(); it != list.rend(); ++it) {
+            v.push_back(it->id);
+        }
+        return v;
+    }
+
+}
+
+TEST_CASE("xorlist_single_word_hook") {
+    CHECK(sizeof(ulink::XorNode<Item>) == sizeof(void*));
+}
+
+TEST_CASE("xorlist_reverse_iterators_do_not_mutate") {
+
+    using List = ulink::XorList<Item>;
+
+    // a reverse iterator holds its successor as "previous" node
+    static_assert(!std::is_same_v<List::iterator, List::reverse_iterator>);
+    static_assert(!std::is_convertible_v<List::reverse_iterator, List::iterator>);
+    static_assert(Erasable<List::iterator>::value);
+    static_assert(!Erasable<List::reverse_iterator>::value);
+    static_assert(Insertable<List::iterator>::value);
+    static_assert(!Insertable<List::reverse_iterator>::value);
+    static_assert(Splicable<List::iterator>::value);
+    static_assert(!Splicable<List::reverse_iterator>::value);
+
+    Item i1(1), i2(2);
+    List list;
+    list.push_back(i1);
+    list.push_back(i2);
+
+    List::const_reverse_iterator it = list.rbegin();
+    CHECK(it->id == 2);
+    CHECK((++it)->id == 1);
+    CHECK(++it == list.rend());
+}
+
+TEST_CASE("xorlist_ends_and_iteration") {
+
+    Item i1(1), i2(2), i3(3), i4(4);
+
+    ulink::XorList<Item> list;
+    CHECK(list.empty());
+    CHECK(list.begin() == list.end());
+
+    list.push_back(i2);
+    list.push_back(i3);
+    list.push_front(i1);
+    list.push_back(i4);
+
+    CHECK(forward(list) == std::vector<int> { 1, 2, 3, 4 });
+    CHECK(backward(list) == std::vector<int> { 4, 3, 2, 1 });
+    CHECK(list.size() == 4);
+    CHECK(list.front().id == 1);
+    CHECK(list.back().id == 4);
+
+    // bidirectional, including back from end()
+    auto it = list.end();
+    --it;
+    CHECK(it->id == 4);
+    --it;
+    CHECK(it->id == 3);
+    it++;
+    CHECK(it->id == 4);
+    CHECK(std::distance(list.begin(), list.end()) == 4);
+
+    list.pop_front();
+    list.pop_back();
+    CHECK(forward(list) == std::vector<int> { 2, 3 });
+    CHECK(backward(list) == std::vector<int> { 3, 2 });
+
+    list.pop_back();
+    list.pop_back();
+    CHECK(list.empty());
+    list.pop_front();
+    CHECK(list.empty());
+}
+
+TEST_CASE("xorlist_insert_erase_remove") {
+
+    Item i1(1), i2(2), i3(3), i4(4), i5(5);
+
+    ulink::XorList<Item> list;
+
+    list.push_back(i1);
+    list.push_back(i4);
+
+    auto it = list.insert_before(std::next(list.begin()), i2);
+    CHECK(it->id == 2);
+    it = list.insert_after(it, i3);
+    CHECK(it->id == 3);
+    list.insert_before(list.end(), i5);
+
+    CHECK(forward(list) == std::vector<int> { 1, 2, 3, 4, 5 });
+    CHECK(backward(list) == std::vector<int> { 5, 4, 3, 2, 1 });
+
+    it = list.erase(std::find_if(list.begin(), list.end(), [] (const Item& i) { return i.id == 3; }));
+    CHECK(it->id == 4);
+    CHECK(forward(list) == std::vector<int> { 1, 2, 4, 5 });
+
+    CHECK(list.remove(i5));
+    CHECK(!list.remove(i5));
+    CHECK(list.contains(i1));
+    CHECK(!list.contains(i3));
+    CHECK(backward(list) == std::vector<int> { 4, 2, 1 });
+
+    list.erase(list.begin());
+    CHECK(list.front().id == 2);
+    CHECK(backward(list) == std::vector<int> { 4, 2 });
+
+    // erase during a walk
+    for (auto e = list.begin(); e != list.end();) {
+        e = list.erase(e);
+    }
+    CHECK(list.empty());
+}
+
+TEST_CASE("xorlist_splice_and_reverse") {
+
+    std::vector<Item> items;
+    for (int i = 0; i < 8; i++) {
+        items.emplace_back(i);
+    }
+
+    ulink::XorList<Item> a;
+    ulink::XorList<Item> b;
+
+    for (int i = 0; i < 4; i++) {
+        a.push_back(items[i]);
+        b.push_back(items[i + 4]);
+    }
+
+    a.splice(std::next(a.begin(), 2), b);
+    CHECK(b.empty());
+    CHECK(forward(a) == std::vector<int> { 0, 1, 4, 5, 6, 7, 2, 3 });
+    CHECK(backward(a) == std::vector<int> { 3, 2, 7, 6, 5, 4, 1, 0 });
+
+    a.reverse();
+    CHECK(forward(a) == std::vector<int> { 3, 2, 7, 6, 5, 4, 1, 0 });
+
+    // the reversed list stays fully usable
+    Item& first = a.front();
+    a.pop_front();
+    b.push_back(first);
+    b.splice(b.begin(), a);
+    CHECK(a.empty());
+    CHECK(forward(b) == std::vector<int> { 2, 7, 6, 5, 4, 1, 0, 3 });
+
+    a.splice(a.end(), b);
+    CHECK(backward(a) == std::vector<int> { 3, 0, 1, 4, 5, 6, 7, 2 });
+
+    a.clear();
+    CHECK(a.empty());
+}